@@ -9,19 +9,32 @@
 #include "Bounce.h"
 
 
+BounceClock Bounce::clockFn = millis;
+
+
 Bounce::Bounce(uint8_t pin,unsigned long interval_millis)
 {
 	interval(interval_millis);
-	previous_millis = millis();
+	previous_millis = now();
 	state = digitalRead(pin);
     this->pin = pin;
 }
 
 
+Bounce::Bounce(unsigned long interval_millis)
+{
+	interval(interval_millis);
+	previous_millis = now();
+	state = 0;
+	stateChanged = 0;
+	this->pin = BOUNCE_NO_PIN;
+}
+
+
 void Bounce::write(int new_state)
        {
        	this->state = new_state;
-       	digitalWrite(pin,state);
+       	if (pin != BOUNCE_NO_PIN) digitalWrite(pin,state);
        }
 
 
@@ -40,15 +53,27 @@ void Bounce::rebounce(unsigned long interval)
 
 int Bounce::update()
 {
-	if ( debounce() ) {
+	return update(now());
+}
+
+
+int Bounce::update(unsigned long now_millis)
+{
+	return feed((pin != BOUNCE_NO_PIN) ? digitalRead(pin) : state, now_millis);
+}
+
+
+int Bounce::feed(uint8_t newState, unsigned long now_millis)
+{
+	if ( debounce(newState, now_millis) ) {
         rebounce(0);
         return stateChanged = 1;
     }
 
      // We need to rebounce, so simulate a state change
      
-	if ( rebounce_millis && (millis() - previous_millis >= rebounce_millis) ) {
-        previous_millis = millis();
+	if ( rebounce_millis && (now_millis - previous_millis >= rebounce_millis) ) {
+        previous_millis = now_millis;
 		 rebounce(0);
 		 return stateChanged = 1;
 	}
@@ -57,9 +82,30 @@ int Bounce::update()
 }
 
 
+void Bounce::updateAll(Bounce* const* bounces, uint8_t count)
+{
+	unsigned long now_millis = now();
+	for (uint8_t i = 0; i < count; i++) {
+		bounces[i]->update(now_millis);
+	}
+}
+
+
+void Bounce::setClock(BounceClock clock)
+{
+	clockFn = clock ? clock : millis;
+}
+
+
+unsigned long Bounce::now()
+{
+	return clockFn();
+}
+
+
 unsigned long Bounce::duration()
 {
-  return millis() - previous_millis;
+  return now() - previous_millis;
 }
 
 
@@ -69,13 +115,12 @@ int Bounce::read()
 }
 
 
-// Protected: debounces the pin
-int Bounce::debounce() {
+// Protected: debounces the state read from the pin or given to feed()
+int Bounce::debounce(uint8_t newState, unsigned long now_millis) {
 	
-	uint8_t newState = digitalRead(pin);
 	if (state != newState ) {
-  		if (millis() - previous_millis >= interval_millis) {
-  			previous_millis = millis();
+  		if (now_millis - previous_millis >= interval_millis) {
+  			previous_millis = now_millis;
   			state = newState;
   			return 1;
 	}
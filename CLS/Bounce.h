@@ -30,18 +30,36 @@
 
 #include <inttypes.h>
 
+// Function returning the time in milliseconds, millis by default
+typedef unsigned long (*BounceClock)(void);
+
+// Pin of a Bounce fed with feed() instead of reading a pin
+#define BOUNCE_NO_PIN 0xFF
+
 class Bounce
 {
 
 public:
 	// Initialize
   Bounce(uint8_t pin, unsigned long interval_millis ); 
+	// Initialize without a pin, the state is given to feed(), e.g. by a key matrix
+  Bounce(unsigned long interval_millis = 10);
 	// Sets the debounce interval
   void interval(unsigned long interval_millis); 
 	// Updates the pin
 	// Returns 1 if the state changed
 	// Returns 0 if the state did not change
   int update(); 
+	// Updates the pin at a time read once for many pins, e.g. by updateAll
+  virtual int update(unsigned long now_millis);
+	// Updates from a state read by the caller instead of the pin
+  int feed(uint8_t newState, unsigned long now_millis);
+	// Updates the pins with one read of the clock
+  static void updateAll(Bounce* const* bounces, uint8_t count);
+	// Sets the clock of all the instances, e.g. a mocked one for host tests
+  static void setClock(BounceClock clock);
+	// Returns the time of the clock
+  static unsigned long now();
 	// Forces the pin to signal a change (through update()) in X milliseconds 
 	// even if the state does not actually change
 	// Example: press and hold a button and have it repeat every X milliseconds
@@ -58,7 +76,8 @@ public:
 	bool fallingEdge();
   
 protected:
-  int debounce();
+  int debounce(uint8_t newState, unsigned long now_millis);
+  static BounceClock clockFn;
   unsigned long  previous_millis, interval_millis, rebounce_millis;
   uint8_t state;
   uint8_t pin;
@@ -0,0 +1,114 @@
+
+// Please read Bounce.h for information about the liscence and authors
+
+#if defined(ARDUINO) && ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+#include "BounceBank.h"
+
+
+BounceBank::BounceBank(unsigned long interval_millis)
+{
+	interval(interval_millis);
+	previous_millis = Bounce::now();
+	runCount = 0;
+	pinCount = 0;
+	state = 0;
+	count0 = 0xFFFFFFFF;
+	count1 = 0xFFFFFFFF;
+	changed = 0;
+}
+
+
+int BounceBank::addPin(uint8_t pin)
+{
+	if (pinCount >= BOUNCEBANK_PINS) {
+		return -1;
+	}
+	volatile uint32_t* reg = (volatile uint32_t*)portInputRegister(digitalPinToPort(pin));
+	uint32_t mask = digitalPinToBitMask(pin);
+	uint8_t shift = 0;
+	while (!(mask & (1UL << shift))) {
+		shift++;
+	}
+	// Extend the last run when the pin is the next one of the same port
+	run* r = (runCount > 0) ? &runs[runCount - 1] : 0;
+	if (r != 0 && r->reg == reg && shift > 0 && (r->mask & (1UL << (shift - 1))) && (r->mask >> shift) == 0) {
+		r->mask |= mask;
+	}
+	else {
+		r = &runs[runCount++];
+		r->reg = reg;
+		r->mask = mask;
+		r->shift = shift;
+		r->bit = pinCount;
+	}
+	if (digitalRead(pin)) {
+		state |= 1UL << pinCount;
+	}
+	return pinCount++;
+}
+
+
+void BounceBank::interval(unsigned long interval_millis)
+{
+	this->sample_millis = interval_millis / BOUNCEBANK_SAMPLES;
+	if (this->sample_millis == 0) {
+		this->sample_millis = 1;
+	}
+}
+
+
+uint32_t BounceBank::update()
+{
+	return update(Bounce::now());
+}
+
+
+uint32_t BounceBank::update(unsigned long now_millis)
+{
+	changed = 0;
+	if (now_millis - previous_millis < sample_millis) {
+		return 0;
+	}
+	previous_millis = now_millis;
+	// Each counter bit pair counts the samples an input differs from its state,
+	// it is reset when the input agrees and toggles the state when it rolls over
+	uint32_t delta = sample() ^ state;
+	count0 = ~(count0 & delta);
+	count1 = count0 ^ (count1 & delta);
+	changed = delta & count0 & count1;
+	state ^= changed;
+	return changed;
+}
+
+
+uint32_t BounceBank::read()
+{
+	return state;
+}
+
+
+int BounceBank::read(uint8_t bit)
+{
+	return (int)((state >> bit) & 1);
+}
+
+
+uint32_t BounceBank::rose() { return changed & state; }
+uint32_t BounceBank::fell() { return changed & ~state; }
+bool BounceBank::risingEdge(uint8_t bit) { return (rose() >> bit) & 1; }
+bool BounceBank::fallingEdge(uint8_t bit) { return (fell() >> bit) & 1; }
+
+
+// Protected: reads the port of each run once
+uint32_t BounceBank::sample()
+{
+	uint32_t bits = 0;
+	for (uint8_t i = 0; i < runCount; i++) {
+		bits |= ((*runs[i].reg & runs[i].mask) >> runs[i].shift) << runs[i].bit;
+	}
+	return bits;
+}
@@ -0,0 +1,71 @@
+
+// BounceBank debounces up to 32 inputs together, see Bounce.h for the licence
+
+/*  * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ The inputs are read from their port registers, one read for each run of
+ consecutive pins of a port, and debounced in parallel with 2 bit vertical
+ counters: bit n of each counter word belongs to input n. An input changes
+ state once it was read in the other state at 4 samples in a row, taken
+ every interval_millis / 4 ms, so one update() costs about the same for 1 or
+ 32 inputs.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef BounceBank_h
+#define BounceBank_h
+
+#include <inttypes.h>
+#include "Bounce.h"
+
+// Number of inputs of a bank, one bit each in the masks
+#define BOUNCEBANK_PINS 32
+// Number of samples an input has to be stable in the new state
+#define BOUNCEBANK_SAMPLES 4
+
+class BounceBank
+{
+
+public:
+	// Initialize, with no input
+  BounceBank(unsigned long interval_millis);
+	// Adds an input, already configured with pinMode
+	// Returns the bit of the input in the masks
+	// Returns -1 if the bank is full
+  int addPin(uint8_t pin);
+	// Sets the debounce interval
+  void interval(unsigned long interval_millis);
+	// Updates all the inputs
+	// Returns the mask of the inputs whose state changed, 0 if none did
+  uint32_t update();
+	// Updates all the inputs at a time read from the clock of Bounce
+  uint32_t update(unsigned long now_millis);
+	// Returns the updated states, bit n for the input n
+  uint32_t read();
+	// Returns the updated state of an input
+  int read(uint8_t bit);
+	// The rose mask has the bits of the inputs that went from off-to-on,
+	// for one scan, like risingEdge of Bounce
+  uint32_t rose();
+	// The fell mask has the bits of the inputs that went from on-to-off, for one scan
+  uint32_t fell();
+  bool risingEdge(uint8_t bit);
+  bool fallingEdge(uint8_t bit);
+
+protected:
+	// Reads all the inputs, bit n for the input n
+  uint32_t sample();
+  // A run of consecutive pins of a port, given consecutive bits of the bank
+  struct run {
+    volatile uint32_t* reg;
+    uint32_t mask;
+    uint8_t shift;
+    uint8_t bit;
+  };
+  run runs[BOUNCEBANK_PINS];
+  uint8_t runCount;
+  uint8_t pinCount;
+  unsigned long previous_millis, sample_millis;
+  // Debounced states, vertical counters, and the changes of the last update
+  uint32_t state, count0, count1, changed;
+};
+
+#endif
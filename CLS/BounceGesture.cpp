@@ -0,0 +1,122 @@
+
+// Please read Bounce.h for information about the liscence and authors
+
+#if defined(ARDUINO) && ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+#include "BounceGesture.h"
+
+// States, the pressed ones first
+#define GS_DOWN 0		// pressed, waiting for release or long press
+#define GS_HELD 1		// long pressed, repeating
+#define GS_DOWN2 2		// pressed again after a double click, waiting for release
+#define GS_IDLE 3		// released
+#define GS_GAP 4		// released after a short press, waiting for a second one
+#define GS_PRESSED_LAST GS_DOWN2
+
+// Inputs
+#define GI_PRESS 0
+#define GI_RELEASE 1
+#define GI_TIMEOUT 2
+
+// Transitions: next state in the high nibble, event in the low one
+#define GT(state, event) (((state) << 4) | (event))
+
+static const uint8_t transitions[5][3] = {
+	//				press							release								timeout
+	/* DOWN */	{ GT(GS_DOWN, 0),				GT(GS_GAP, 0),						GT(GS_HELD, BOUNCEGESTURE_LONG_PRESS) },
+	/* HELD */	{ GT(GS_HELD, 0),				GT(GS_IDLE, 0),						GT(GS_HELD, BOUNCEGESTURE_REPEAT) },
+	/* DOWN2 */	{ GT(GS_DOWN2, 0),				GT(GS_IDLE, 0),						GT(GS_DOWN2, 0) },
+	/* IDLE */	{ GT(GS_DOWN, 0),				GT(GS_IDLE, 0),						GT(GS_IDLE, 0) },
+	/* GAP */	{ GT(GS_DOWN2, BOUNCEGESTURE_DOUBLE_CLICK), GT(GS_GAP, 0),			GT(GS_IDLE, BOUNCEGESTURE_CLICK) }
+};
+
+static const BounceGestureTimes defaultTimes = {250, 600, 400, 50, 50};
+
+const BounceGestureTimes* BounceGesture::times = &defaultTimes;
+
+
+BounceGesture::BounceGesture()
+{
+	fsm = GS_IDLE;
+	repeat_count = 0;
+	since_millis = 0;
+}
+
+
+void BounceGesture::setTimes(const BounceGestureTimes* times)
+{
+	BounceGesture::times = times ? times : &defaultTimes;
+}
+
+
+uint8_t BounceGesture::update(Bounce& button, uint8_t pressedLevel)
+{
+	unsigned long now_millis = Bounce::now();
+	return step(button.read() == pressedLevel, now_millis, now_millis - button.duration());
+}
+
+
+uint8_t BounceGesture::update(bool pressed, unsigned long now_millis)
+{
+	return step(pressed, now_millis, now_millis);
+}
+
+
+// Protected: the edge, if the state does not match the button, happened at edge_millis
+uint8_t BounceGesture::step(bool pressed, unsigned long now_millis, unsigned long edge_millis)
+{
+	uint8_t input;
+	bool edge = pressed != (fsm <= GS_PRESSED_LAST);
+	uint16_t elapsed = (uint16_t)(edge ? edge_millis : now_millis) - since_millis;
+	uint16_t wait = timeout();
+	// A timeout that was over before the edge comes first
+	if (wait != 0xFFFF && elapsed >= wait) {
+		input = GI_TIMEOUT;
+		// Keeps the repeats on time when update() is a little late, drops them when it is very late
+		since_millis += (edge || elapsed < 2 * (uint32_t)wait) ? wait : elapsed;
+	}
+	else if (edge) {
+		input = pressed ? GI_PRESS : GI_RELEASE;
+		since_millis = (uint16_t)edge_millis;
+	}
+	else {
+		return BOUNCEGESTURE_NONE;
+	}
+	uint8_t next = transitions[fsm][input];
+	uint8_t event = next & 0x0F;
+	if (event == BOUNCEGESTURE_LONG_PRESS) {
+		repeat_count = 0;
+	}
+	else if (event == BOUNCEGESTURE_REPEAT && repeat_count < 0xFF) {
+		repeat_count++;
+	}
+	fsm = next >> 4;
+	return event;
+}
+
+
+uint8_t BounceGesture::repeats()
+{
+	return repeat_count;
+}
+
+
+// Protected: time the state waits for, 0xFFFF for none
+uint16_t BounceGesture::timeout()
+{
+	switch (fsm) {
+	case GS_DOWN:
+		return times->long_ms;
+	case GS_GAP:
+		return times->double_ms;
+	case GS_HELD: {
+		uint32_t step = (uint32_t)times->repeat_step_ms * repeat_count;
+		return (times->repeat_ms > step + times->repeat_min_ms) ? times->repeat_ms - step : times->repeat_min_ms;
+	}
+	default:
+		return 0xFFFF;
+	}
+}
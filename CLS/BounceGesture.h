@@ -0,0 +1,70 @@
+
+// BounceGesture recognizes the gestures of a button debounced by Bounce,
+// see Bounce.h for the licence
+
+/*  * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ Each button has a small state machine, stepped by a transition table shared
+ by all the buttons, with the thresholds of one BounceGestureTimes also
+ shared, so a button only keeps 4 bytes: its state, its repeat count and the
+ time of its last transition. update() returns at most one event a call:
+  - click: a press released before long_ms, with no second press within
+    double_ms (immediately on release when double_ms is 0)
+  - double click: a second press within double_ms of the release
+  - long press: a press held for long_ms
+  - repeat: then every repeat_ms while held, shortened by repeat_step_ms
+    after each repeat down to repeat_min_ms
+ The state follows the level of the button, so update() can be called less
+ often than Bounce::update(), as long as a press or a release lasts longer
+ than the time between two calls; the events then come out late, in order.
+ With a Bounce, the time of the edge is taken from duration(), so a late
+ call does not turn a click into a long press.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef BounceGesture_h
+#define BounceGesture_h
+
+#include <inttypes.h>
+#include "Bounce.h"
+
+// Events returned by update()
+#define BOUNCEGESTURE_NONE 0
+#define BOUNCEGESTURE_CLICK 1
+#define BOUNCEGESTURE_DOUBLE_CLICK 2
+#define BOUNCEGESTURE_LONG_PRESS 3
+#define BOUNCEGESTURE_REPEAT 4
+
+// Thresholds of the gestures, in milliseconds
+struct BounceGestureTimes {
+  uint16_t double_ms;
+  uint16_t long_ms;
+  uint16_t repeat_ms;
+  uint16_t repeat_min_ms;
+  uint16_t repeat_step_ms;
+};
+
+class BounceGesture
+{
+
+public:
+	// Initialize, the button released
+  BounceGesture();
+	// Sets the thresholds of all the buttons, NULL for the defaults
+  static void setTimes(const BounceGestureTimes* times);
+	// Updates from a button already updated, pressed when it reads pressedLevel
+	// Returns the event, BOUNCEGESTURE_NONE if there is none
+  uint8_t update(Bounce& button, uint8_t pressedLevel = 1);
+	// Updates from the debounced state of a button at a time of Bounce::now()
+  uint8_t update(bool pressed, unsigned long now_millis);
+	// Returns the number of repeats since the long press
+  uint8_t repeats();
+
+protected:
+  uint8_t step(bool pressed, unsigned long now_millis, unsigned long edge_millis);
+  uint16_t timeout();
+  static const BounceGestureTimes* times;
+  uint8_t fsm;
+  uint8_t repeat_count;
+  uint16_t since_millis;
+};
+
+#endif
@@ -0,0 +1,210 @@
+
+// Please read Bounce.h for information about the liscence and authors
+
+#if defined(ARDUINO) && ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+#include "BounceMatrix.h"
+
+
+BounceMatrix::BounceMatrix(unsigned long interval_millis, unsigned long scan_millis)
+{
+	for (uint8_t i = 0; i < BOUNCEMATRIX_KEYS; i++) {
+		keys[i].interval(interval_millis);
+	}
+	rows = 0;
+	cols = 0;
+	withDiodes = false;
+	ghost = false;
+	edges = false;
+	this->scan_millis = scan_millis;
+	previous_millis = Bounce::now() - scan_millis;
+	rate_millis = Bounce::now();
+	scan_micros = 0;
+	scan_micros_max = 0;
+	rate = 0;
+	rate_count = 0;
+}
+
+
+int BounceMatrix::begin(const uint8_t* rowPins, uint8_t rows, const uint8_t* colPins, uint8_t cols)
+{
+	if (rows > BOUNCEMATRIX_LINES || cols > BOUNCEMATRIX_LINES || rows * cols > BOUNCEMATRIX_KEYS) {
+		return -1;
+	}
+	this->rows = rows;
+	this->cols = cols;
+	for (uint8_t r = 0; r < rows; r++) {
+		this->rowPins[r] = rowPins[r];
+		pinMode(rowPins[r], INPUT);
+	}
+	for (uint8_t c = 0; c < cols; c++) {
+		this->colPins[c] = colPins[c];
+#if defined(INPUT_PULLUP)
+		pinMode(colPins[c], INPUT_PULLUP);
+#else
+		pinMode(colPins[c], INPUT);
+#endif
+	}
+	return 0;
+}
+
+
+void BounceMatrix::diodes(bool withDiodes)
+{
+	this->withDiodes = withDiodes;
+}
+
+
+int BounceMatrix::update()
+{
+	return update(Bounce::now());
+}
+
+
+int BounceMatrix::update(unsigned long now_millis)
+{
+	uint8_t rowBits[BOUNCEMATRIX_LINES];
+	uint8_t held[BOUNCEMATRIX_LINES];
+	int changes = 0;
+	if (now_millis - previous_millis < scan_millis) {
+		// The edges of the last scan are true for one update only
+		if (edges) {
+			for (uint8_t i = 0; i < rows * cols; i++) {
+				keys[i].feed(keys[i].read(), now_millis);
+			}
+			edges = false;
+		}
+		return 0;
+	}
+	previous_millis = now_millis;
+	unsigned long start_micros = micros();
+	scan(rowBits);
+	// Keys pressed in 2 columns of 2 rows may hide a ghost, they keep their state
+	for (uint8_t r = 0; r < rows; r++) {
+		held[r] = 0;
+	}
+	ghost = false;
+	if (!withDiodes) {
+		for (uint8_t r1 = 0; r1 < rows; r1++) {
+			for (uint8_t r2 = r1 + 1; r2 < rows; r2++) {
+				uint8_t common = rowBits[r1] & rowBits[r2];
+				if (common & (common - 1)) {
+					held[r1] |= common;
+					held[r2] |= common;
+					ghost = true;
+				}
+			}
+		}
+	}
+	for (uint8_t r = 0; r < rows; r++) {
+		for (uint8_t c = 0; c < cols; c++) {
+			Bounce& k = keys[r * cols + c];
+			uint8_t level = (held[r] & (1 << c)) ? k.read() : (rowBits[r] >> c) & 1;
+			changes += k.feed(level, now_millis);
+		}
+	}
+	edges = changes > 0;
+	scan_micros = micros() - start_micros;
+	if (scan_micros > scan_micros_max) {
+		scan_micros_max = scan_micros;
+	}
+	rate_count++;
+	if (now_millis - rate_millis >= 1000) {
+		rate = (uint16_t)(rate_count * 1000UL / (now_millis - rate_millis));
+		rate_count = 0;
+		rate_millis = now_millis;
+	}
+	return changes;
+}
+
+
+Bounce& BounceMatrix::key(uint8_t index)
+{
+	return keys[index];
+}
+
+
+Bounce& BounceMatrix::key(uint8_t row, uint8_t col)
+{
+	return keys[row * cols + col];
+}
+
+
+uint8_t BounceMatrix::keyCount()
+{
+	return rows * cols;
+}
+
+
+int BounceMatrix::risingKey()
+{
+	for (uint8_t i = 0; i < rows * cols; i++) {
+		if (keys[i].risingEdge()) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+
+uint8_t BounceMatrix::pressedCount()
+{
+	uint8_t count = 0;
+	for (uint8_t i = 0; i < rows * cols; i++) {
+		count += keys[i].read();
+	}
+	return count;
+}
+
+
+bool BounceMatrix::ghosting()
+{
+	return ghost;
+}
+
+
+unsigned long BounceMatrix::scanMicros()
+{
+	return scan_micros;
+}
+
+
+unsigned long BounceMatrix::scanMicrosMax()
+{
+	return scan_micros_max;
+}
+
+
+uint16_t BounceMatrix::scanRate()
+{
+	return rate;
+}
+
+
+uint16_t BounceMatrix::loadPermille()
+{
+	// without a cadence update() scans every time, the scans take all it is given
+	if (scan_millis == 0) return 1000;
+	return (uint16_t)(scan_micros_max / scan_millis);
+}
+
+
+// Protected: reads the keys, bit c of rowBits[r] set when the key is pressed
+void BounceMatrix::scan(uint8_t* rowBits)
+{
+	for (uint8_t r = 0; r < rows; r++) {
+		pinMode(rowPins[r], OUTPUT);
+		digitalWrite(rowPins[r], LOW);
+		delayMicroseconds(BOUNCEMATRIX_SETTLE_US);
+		rowBits[r] = 0;
+		for (uint8_t c = 0; c < cols; c++) {
+			if (digitalRead(colPins[c]) == LOW) {
+				rowBits[r] |= 1 << c;
+			}
+		}
+		pinMode(rowPins[r], INPUT);
+	}
+}
@@ -0,0 +1,79 @@
+
+// BounceMatrix scans a key matrix and debounces each key with Bounce,
+// see Bounce.h for the licence
+
+/*  * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ Every scan_millis update() drives each row low in turn, the other rows
+ left floating, and reads the columns, held high by pull ups, so a pressed
+ key reads low on its column. Each key is a Bounce without pin, fed with
+ what the scan read, so it is debounced like a button and key() gives its
+ read, risingEdge, fallingEdge, duration and rebounce. A key reads 1 when
+ pressed.
+ Every key is debounced on its own, so any number can be held together
+ (n-key rollover) when each key has a diode. Without diodes, 3 keys pressed
+ at the corners of a rectangle make the 4th corner read as pressed too:
+ when 2 rows read 2 or more of the same columns, the keys of those columns
+ keep their state until the scan is clear again, and ghosting() is true.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef BounceMatrix_h
+#define BounceMatrix_h
+
+#include <inttypes.h>
+#include "Bounce.h"
+
+// Number of keys of a matrix, rows times columns. It sizes keys[], so it is
+// fixed: the library and the sketch have to agree on the size of the class
+#define BOUNCEMATRIX_KEYS 16
+// Number of rows or columns, at most 8
+#define BOUNCEMATRIX_LINES 8
+// Time for the columns to follow the row driven low, in us
+#define BOUNCEMATRIX_SETTLE_US 5
+
+class BounceMatrix
+{
+
+public:
+	// Initialize, debouncing the keys over interval_millis with a scan every scan_millis
+  BounceMatrix(unsigned long interval_millis, unsigned long scan_millis);
+	// Sets the pins, the key of row r and column c is key(r * cols + c)
+	// Returns 0, or -1 if there are more lines or keys than allowed
+  int begin(const uint8_t* rowPins, uint8_t rows, const uint8_t* colPins, uint8_t cols);
+	// Tells that each key has a diode, so no key can be a ghost
+  void diodes(bool withDiodes);
+	// Scans the keys once scan_millis is over
+	// Returns the number of keys whose state changed
+  int update();
+  int update(unsigned long now_millis);
+	// Returns a key, updated by the last scan
+  Bounce& key(uint8_t index);
+  Bounce& key(uint8_t row, uint8_t col);
+  uint8_t keyCount();
+	// Returns the first key pressed by the last update, -1 if none was
+  int risingKey();
+	// Returns the number of keys held
+  uint8_t pressedCount();
+	// Returns true if the last scan saw keys that could be ghosts
+  bool ghosting();
+	// Returns the time taken by the last scan and the longest one, in us
+  unsigned long scanMicros();
+  unsigned long scanMicrosMax();
+	// Returns the scans done in the last second
+  uint16_t scanRate();
+	// Returns the share of the time taken by the scans, in 1/1000, from the longest one
+	// (1000 when scan_millis is 0)
+  uint16_t loadPermille();
+
+protected:
+  void scan(uint8_t* rowBits);
+  Bounce keys[BOUNCEMATRIX_KEYS];
+  uint8_t rowPins[BOUNCEMATRIX_LINES];
+  uint8_t colPins[BOUNCEMATRIX_LINES];
+  uint8_t rows, cols;
+  bool withDiodes, ghost, edges;
+  unsigned long scan_millis, previous_millis, rate_millis;
+  unsigned long scan_micros, scan_micros_max;
+  uint16_t rate, rate_count;
+};
+
+#endif
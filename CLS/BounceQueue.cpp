@@ -0,0 +1,173 @@
+
+// Please read Bounce.h for information about the liscence and authors
+
+#if defined(ARDUINO) && ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+#include "BounceQueue.h"
+
+
+BounceQueue* BounceQueue::owners[BOUNCEQUEUE_IRQS];
+
+
+
+BounceQueue::BounceQueue(uint8_t pin, uint8_t irq, unsigned long interval_millis)
+	: Bounce(pin, interval_millis)
+{
+	this->irq = irq;
+	head = 0;
+	tail = 0;
+	lost = 0;
+	attached = false;
+	armedLevel = state;
+	rawLevel = state;
+	raw_micros = micros();
+	// The first edge is taken at once
+	change_micros = raw_micros - interval_millis * 1000;
+}
+
+
+void BounceQueue::begin()
+{
+	if (irq >= BOUNCEQUEUE_IRQS) {
+		return;
+	}
+	noInterrupts();
+	owners[irq] = this;
+	attached = true;
+	armedLevel = digitalRead(pin);
+	arm(armedLevel);
+	interrupts();
+}
+
+
+void BounceQueue::end()
+{
+	if (attached) {
+		detachInterrupt(irq);
+		attached = false;
+		owners[irq] = 0;
+	}
+}
+
+
+int BounceQueue::update()
+{
+	return update(now());
+}
+
+
+int BounceQueue::update(unsigned long now_millis)
+{
+	unsigned long interval_micros = interval_millis * 1000;
+	if (tail == head) {
+		resync();
+	}
+	while (tail != head) {
+		rawLevel = levels[tail];
+		raw_micros = times[tail];
+		tail = (tail + 1) & (BOUNCEQUEUE_EVENTS - 1);
+		if (rawLevel != state && raw_micros - change_micros >= interval_micros) {
+			return change(rawLevel, raw_micros, now_millis);
+		}
+	}
+	// The pin settled in the other level before the interval was over, the
+	// change is taken once the interval is over, dated by its last edge
+	if (rawLevel != state && micros() - change_micros >= interval_micros) {
+		return change(rawLevel, raw_micros, now_millis);
+	}
+
+     // We need to rebounce, so simulate a state change
+
+	if ( rebounce_millis && (now_millis - previous_millis >= rebounce_millis) ) {
+		previous_millis = now_millis;
+		rebounce(0);
+		return stateChanged = 1;
+	}
+
+	return stateChanged = 0;
+}
+
+
+unsigned long BounceQueue::eventMicros()
+{
+	return change_micros;
+}
+
+
+unsigned long BounceQueue::overflows()
+{
+	return lost;
+}
+
+
+// Protected: takes a change at now_millis, duration() counts from its edge
+int BounceQueue::change(uint8_t level, unsigned long us, unsigned long now_millis)
+{
+	state = level;
+	change_micros = us;
+	previous_millis = now_millis - (micros() - us) / 1000;
+	rebounce(0);
+	return stateChanged = 1;
+}
+
+
+// Protected: called by the interrupt, and by resync with the interrupts disabled
+void BounceQueue::push(uint8_t level, unsigned long us)
+{
+	uint8_t next = (head + 1) & (BOUNCEQUEUE_EVENTS - 1);
+	if (next == tail) {
+		lost++;
+	}
+	else {
+		times[head] = us;
+		levels[head] = level;
+		head = next;
+	}
+}
+
+
+void BounceQueue::arm(uint8_t level)
+{
+	static void (* const isrs[BOUNCEQUEUE_IRQS])(void) = {isr0, isr1, isr2, isr3, isr4};
+	armedLevel = level;
+	if (attached) {
+		attachInterrupt(irq, isrs[irq], level ? FALLING : RISING);
+	}
+}
+
+
+void BounceQueue::edge()
+{
+	uint8_t level = digitalRead(pin);
+	// The pin may have bounced back before it was read, then wait for the same edge again
+	if (level != armedLevel) {
+		push(level, micros());
+		arm(level);
+	}
+}
+
+
+// Protected: an edge can be missed between the read of the pin and arming the
+// next one, or dropped by a full queue, so the pin is read when the queue is empty
+void BounceQueue::resync()
+{
+	noInterrupts();
+	uint8_t level = digitalRead(pin);
+	if (level != armedLevel) {
+		arm(level);
+	}
+	if (tail == head && level != rawLevel) {
+		push(level, micros());
+	}
+	interrupts();
+}
+
+
+void BounceQueue::isr0() { if (owners[0]) owners[0]->edge(); }
+void BounceQueue::isr1() { if (owners[1]) owners[1]->edge(); }
+void BounceQueue::isr2() { if (owners[2]) owners[2]->edge(); }
+void BounceQueue::isr3() { if (owners[3]) owners[3]->edge(); }
+void BounceQueue::isr4() { if (owners[4]) owners[4]->edge(); }
@@ -0,0 +1,75 @@
+
+// BounceQueue debounces a pin from the edges timestamped by an interrupt,
+// see Bounce.h for the licence
+
+/*  * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ An external interrupt on the pin stores the time and level of each edge
+ in a queue, so a press shorter than the time loop() is busy is not lost.
+ update() debounces the queued edges like Bounce: a change is taken when it
+ comes interval_millis after the previous one. It reports one change per
+ call, dated by eventMicros() with the time of its edge, and read,
+ risingEdge, fallingEdge, duration and rebounce keep working as in Bounce.
+ The interrupt is armed for the edge opposite to the level it last saw,
+ since the external interrupts of the PIC32 take RISING or FALLING only.
+* * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef BounceQueue_h
+#define BounceQueue_h
+
+#include <inttypes.h>
+#include "Bounce.h"
+
+// Number of edges the queue can hold, a power of 2
+#define BOUNCEQUEUE_EVENTS 16
+// Number of external interrupts, INT0 to INT4 on chipKIT boards
+#define BOUNCEQUEUE_IRQS 5
+
+class BounceQueue : public Bounce
+{
+
+public:
+	// Initialize, irq is the external interrupt number of the pin
+  BounceQueue(uint8_t pin, uint8_t irq, unsigned long interval_millis);
+	// Attaches the interrupt, to be called from setup()
+	// Without it the pin is only read by update(), as Bounce does
+  void begin();
+	// Detaches the interrupt
+  void end();
+	// Debounces the queued edges
+	// Returns 1 if the state changed, once for each change
+	// Returns 0 if the state did not change
+  int update();
+  int update(unsigned long now_millis);
+	// Returns the micros() time of the edge of the last change
+  unsigned long eventMicros();
+	// Returns the number of edges lost because the queue was full
+  unsigned long overflows();
+
+protected:
+	// Called by the interrupt with the level of the pin
+  void edge();
+  void push(uint8_t level, unsigned long us);
+  void arm(uint8_t level);
+	// Catches up with the pin when an edge was missed
+  void resync();
+  int change(uint8_t level, unsigned long us, unsigned long now_millis);
+  static void isr0();
+  static void isr1();
+  static void isr2();
+  static void isr3();
+  static void isr4();
+  static BounceQueue* owners[BOUNCEQUEUE_IRQS];
+  // Edges written by the interrupt at head, read by update() at tail
+  volatile unsigned long times[BOUNCEQUEUE_EVENTS];
+  volatile uint8_t levels[BOUNCEQUEUE_EVENTS];
+  volatile uint8_t head, tail;
+  volatile uint8_t armedLevel;
+  volatile unsigned long lost;
+  uint8_t irq;
+  bool attached;
+  // Level and time of the last edge read from the queue, time of the last change
+  uint8_t rawLevel;
+  unsigned long raw_micros, change_micros;
+};
+
+#endif
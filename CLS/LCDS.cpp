@@ -24,6 +24,21 @@
 #include <LCDS.h>
 #include "DSPI.h"
 
+/* ------------------------------------------------------------ */
+/*				Local Type and Constant Definitions				*/
+/* ------------------------------------------------------------ */
+#if defined(LCDS_STATS_ENABLE)
+#define LCDS_STAT_CMD_BYTES(cb)		(m_stats.rgcbCmd[m_idxStatCmd] += (cb))
+#define LCDS_STAT_CMD_TRANS(cb)		(m_stats.rgcTransCmd[m_idxStatCmd] += TransCount(cb))
+#else
+#define LCDS_STAT_CMD_BYTES(cb)
+#define LCDS_STAT_CMD_TRANS(cb)
+#endif
+
+//baud rates of SaveBR, by the index saved in the EEPROM
+static const uint32_t rgdwBaudLcds[] = {2400, 4800, 9600, 19200, 38400, 76800};
+#define LCDS_BAUD_COUNT		(sizeof(rgdwBaudLcds) / sizeof(rgdwBaudLcds[0]))
+
 /* ------------------------------------------------------------ */
 /*				Procedure Definitions							*/
 /* ------------------------------------------------------------ */
@@ -50,13 +65,54 @@
 LCDS::LCDS()
 {
 	pdspi = NULL;
+	m_dwSpeed = LCDS_SPD_DEFAULT;
+	m_pfnSend = NULL;
+	m_pvSendCtx = NULL;
+	m_fShadow = true;
+	m_fCrsShown = false;
+	m_cbBatch = 0;
+	m_cBatchDepth = 0;
+	m_cBatchSends = 0;
+	m_cBatchTrans = 0;
+	m_cTransSaved = 0;
+	m_fAsync = false;
+	m_fPolling = false;
+	m_modeTxqFull = LCDS_TXQ_BLOCK;
+	m_cbPoll = LCDS_TXQ_CHUNK;
+	m_ibTxqHead = 0;
+	m_ibTxqTail = 0;
+	m_ibTxqPend = 0;
+	m_cResync = 0;
+	m_fTxqDropped = false;
+	m_imrkHead = 0;
+	m_imrkTail = 0;
+	m_cbTxqHigh = 0;
+	m_cTxqDrop = 0;
+	m_cbI2CBuf = LCDS_I2C_BUF_LEN;
+	m_fSPIBurst = true;
+	m_usSPIGap = 0;
+	m_bI2CAddr = LCDS_I2C_ADDR;
+	m_cDryRun = 0;
+	m_cbDryRun = 0;
+	m_fsBusy = 0;
+	m_usBusyStart = 0;
+	m_usBusy = 0;
+	m_usPaceWait = 0;
+#if defined(LCDS_STATS_ENABLE)
+	memset(&m_stats, 0, sizeof(m_stats));
+	m_idxStatCmd = LCDS_STAT_OTHER;
+#endif
+	ForceResync();
 }
 /* ------------------------------------------------------------------- */
-/** void LCDS::Begin(uint8_t accessType)
+/** void LCDS::Begin(uint8_t accessType, uint8_t bDevSel, uint32_t dwSpeed)
 **
 **	Parameters:
 **		accessType - the SPI port chosen for the communication
-**		
+**		bDevSel - on I2C the TWI address of the display, on SPI the pin of its
+**				chip select, LCDS_DEV_DEFAULT for the default of the port
+**		dwSpeed - the speed the display accepts: the baud rate on UART, the clock
+**				on I2C and SPI; LCDS_SPD_DEFAULT for the speed the display starts with
 **
 **	Return Value:
 **		None
@@ -65,45 +121,79 @@ LCDS::LCDS()
 **		none
 **
 **	Description:
-**		This function initializes and configures the SPI interface 
+**		This function initializes and configures the SPI interface. Several
+**		displays can share a port, each one with its own LCDS object selected
+**		by its address or chip select pin; see LCDSGroup to schedule them.
+**		The speed is only set on the host side, see NegotiateSpeed to move the
+**		display to a faster one. The SPI clock is limited to PAR_SPD_MAX.
 **
 -----------------------------------------------------------------------*/
- void LCDS::Begin(uint8_t accessType) {
+ void LCDS::Begin(uint8_t accessType, uint8_t bDevSel, uint32_t dwSpeed) {
 	// declare the communication port to be used
 	m_accessType = accessType;
+	//a previous Begin may have selected a SPI port
+	pdspi = NULL;
+	ForceResync();
+	if (dwSpeed == LCDS_SPD_DEFAULT) {
+		if (m_accessType == PAR_ACCESS_UART1 || m_accessType == PAR_ACCESS_UART2) {
+			dwSpeed = LCDS_UART_BAUD;
+		}
+		else if (m_accessType == PAR_ACCESS_I2C) {
+			dwSpeed = LCDS_I2C_HZ;
+		}
+		else {
+			dwSpeed = PAR_SPD_MAX;
+		}
+	}
+	m_dwSpeed = dwSpeed;
+#if !defined(LCDS_NO_DSPI)
 	if(m_accessType == PAR_ACCESS_DSPI0) {
-		pdspi = new DSPI0();
+		pdspi = GetDspi0();
 		m_SSPin = PIN_DSPI0_SS;
 	}
 	else if(m_accessType == PAR_ACCESS_DSPI1) {
-		pdspi = new DSPI1();
+		pdspi = GetDspi1();
 		m_SSPin = PIN_DSPI1_SS;
 	}
-	else if(m_accessType == PAR_ACCESS_UART1) {
-		Serial.begin(9600);
+	if (pdspi != NULL && bDevSel != LCDS_DEV_DEFAULT) {
+		m_SSPin = bDevSel;
+	}
+#endif
+#if !defined(LCDS_NO_UART)
+	if(m_accessType == PAR_ACCESS_UART1) {
+		Serial.begin(m_dwSpeed);
 	}
 	else if(m_accessType == PAR_ACCESS_UART2) {
-		Serial1.begin(9600);
+		Serial1.begin(m_dwSpeed);
 	}
-	else if(m_accessType == PAR_ACCESS_I2C){
+#endif
+#if !defined(LCDS_NO_I2C)
+	if(m_accessType == PAR_ACCESS_I2C){
+		m_bI2CAddr = (bDevSel != LCDS_DEV_DEFAULT) ? bDevSel : LCDS_I2C_ADDR;
 		Wire.begin();
+		Wire.setClock(m_dwSpeed);
 	}
+#endif
 	// init SPI 
-	if((m_accessType == PAR_ACCESS_DSPI0)||(m_accessType == PAR_ACCESS_DSPI1) ) {	
+	if(pdspi != NULL) {	
+		if (m_dwSpeed > PAR_SPD_MAX) {
+			m_dwSpeed = PAR_SPD_MAX;
+		}
 		pdspi->setPinSelect(m_SSPin);	
 		pdspi->begin();
-		pdspi->setSpeed(PAR_SPD_MAX);
+		pdspi->setSpeed(m_dwSpeed);
 		pdspi->setMode(DSPI_MODE0);
+		//the chip select is driven by SPISendBytes, deselect the display until then
+		pinMode(m_SSPin, OUTPUT);
+		digitalWrite(m_SSPin, HIGH);
 	}
-	Serial.println("Done initializing");
 }
 /* ------------------------------------------------------------------- */
-/** void LCDS::SPISendBytes(unsigned char* dataChars, int lenght)
+/** void LCDS::Begin(PFNLCDSSEND pfnSend, void* pvCtx)
 **
 **	Parameters:
-**		dataChars - the string to be sent to SPI
-**		lenght - the lenght of the string to be sent
-**		
+**		pfnSend - the function called with the bytes of each transaction
+**		pvCtx - value passed back to pfnSend
 **
 **	Return Value:
 **		None
@@ -112,80 +202,55 @@ LCDS::LCDS()
 **		none
 **
 **	Description:
-**		This function sends an array of characters to the SPI interface using the Arduino standard functions
+**		This function initializes the driver to hand the byte stream to a user
+**		function instead of a bus. It is used to run the library against the
+**		LCDSEmu emulator, or to reach the display through another port.
 **
 -----------------------------------------------------------------------*/
-void LCDS :: SPISendBytes(unsigned char* dataChars, uint8_t lenght){
-	if (pdspi != NULL) {
-		digitalWrite(m_SSPin, LOW);
-		for(int i = 0; i < lenght; i++) {
-			pdspi->transfer(dataChars[i]);
-		}
-		digitalWrite(m_SSPin, HIGH);
-	}
+void LCDS::Begin(PFNLCDSSEND pfnSend, void* pvCtx) {
+	m_accessType = PAR_ACCESS_USER;
+	m_dwSpeed = LCDS_SPD_DEFAULT;
+	m_pfnSend = pfnSend;
+	m_pvSendCtx = pvCtx;
+	pdspi = NULL;
+	ForceResync();
 }
 /* ------------------------------------------------------------------- */
-/** void LCDS::DisplaySet(bool setDisplay, bool setBckl)
+/** DSPI* LCDS::GetDspi0()
+**	DSPI* LCDS::GetDspi1()
 **
 **	Parameters:
-**		setDisplay - boolean parameter through which the display is set on or off
-**		setBckl - boolean parameter through which the backlight is set on or off
-**
+**		none
 **
 **	Return Value:
-**		None
+**		DSPI* - the object driving the corresponding SPI port
 **
 **	Errors:
 **		none
 **
 **	Description:
-**		This function turns the display and the backlight on or off, according to the user's selection
+**		These functions return the single object used for each SPI port. The objects
+**		are statically allocated the first time they are needed, so no heap is used and
+**		a port that is never selected does not get constructed.
 **
 -----------------------------------------------------------------------*/
-void LCDS::DisplaySet(boolean setDisplay, boolean setBckl) {
-    uint8_t dispBcklOff []  = {ESC, BRACKET, '0', DISP_EN_CMD, 0};
-	uint8_t dispOnBckl[] = { ESC, BRACKET, '1', DISP_EN_CMD, 0 };
-	uint8_t dispBcklOn[] = { ESC, BRACKET, '2', DISP_EN_CMD, 0 };
-	uint8_t dispOnBcklOn[] = { ESC, BRACKET, '3', DISP_EN_CMD, 0 };
-	
-	if ((!setDisplay)&&(!setBckl))	{
-		//send the command for both display and backlight off
-		if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)dispBcklOff);
-		else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)dispBcklOff);
-		else if(m_accessType == PAR_ACCESS_I2C){
-			Wire.beginTransmission(0x48); Wire.write(dispBcklOff,4); Wire.endTransmission();
-			}
-		else SPISendBytes(dispBcklOff, 4);
-	}
-	else if ((setDisplay)&&(!setBckl))	{
-		//send the command for display on and backlight off
-		if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)dispOnBckl);
-		else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)dispOnBckl);
-		else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(dispOnBckl,4); Wire.endTransmission();}
-		else SPISendBytes(dispOnBckl, 4);
-		}
-		else if ((!setDisplay)&&(setBckl))	{
-			//send the command for backlight on and display off
-			if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)dispBcklOn);
-			else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)dispBcklOn);
-			else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(dispBcklOn,4); Wire.endTransmission();}
-			else SPISendBytes(dispBcklOn, 4);
-		}
-			else {
-				//send the command for both display and backlight on
-				if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)dispOnBcklOn);
-				else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)dispOnBcklOn);
-				else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(dispOnBcklOn,4); Wire.endTransmission();}
-				else SPISendBytes(dispOnBcklOn, 4);
-			}
+#if !defined(LCDS_NO_DSPI)
+DSPI* LCDS::GetDspi0() {
+	static DSPI0 dspi0;
+	return &dspi0;
+}
+
+DSPI* LCDS::GetDspi1() {
+	static DSPI1 dspi1;
+	return &dspi1;
 }
+#endif
 /* ------------------------------------------------------------------- */
-/** void LCDS::CursorModeSet(bool setCursor, bool setBlink)
+/** void LCDS::SendBytes(const uint8_t* rgbSnd, uint8_t cbSnd)
 **
 **	Parameters:
-**		setCursor - boolean parameter through which the cursor is set on or off
-**		setBlink - boolean parameter through which the blink option is set on or off
-**
+**		rgbSnd - the bytes to be sent to the display
+**		cbSnd - the number of bytes to be sent
 **
 **	Return Value:
 **		None
@@ -194,195 +259,121 @@ void LCDS::DisplaySet(boolean setDisplay, boolean setBckl) {
 **		none
 **
 **	Description:
-**		This function turns the cursor and the blinking option on or off, according to the user's selection
+**		All the commands go through this function. Outside a batch the bytes are
+**		sent at once. Inside a batch they are appended to the batch buffer. When
+**		the buffer is full, only whole transactions are sent and the remaining
+**		bytes stay in the buffer, so the batch goes out in the fewest transactions
+**		the port allows, even if a command ends up split between two of them.
+**		During a dry run the bytes are only counted.
 **
 -----------------------------------------------------------------------*/
-void LCDS::CursorModeSet(boolean setCursor, boolean setBlink) {
-	uint8_t cursorOff[]  		  = {ESC, BRACKET, '0', CURSOR_MODE_CMD, 0};
-	uint8_t cursorOnBlinkOff[]    = {ESC, BRACKET, '1', CURSOR_MODE_CMD, 0};
-	uint8_t cursorBlinkOn[]       = {ESC, BRACKET, '2', CURSOR_MODE_CMD, 0};
-	if (!setCursor)	{
-		//send the command for both display and blink off
-		if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)cursorOff);
-		else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)cursorOff);
-		else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(cursorOff,4); Wire.endTransmission();}
-		else SPISendBytes(cursorOff, 4);
+void LCDS::SendBytes(const uint8_t* rgbSnd, uint8_t cbSnd) {
+	if (m_cDryRun > 0) {
+		//the commands are only evaluated, count their bytes
+		m_cbDryRun += cbSnd;
+		return;
 	}
-	else if ((setCursor)&&(!setBlink)) {
-		//send the command for display on and blink off
-		if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)cursorOnBlinkOff);
-		else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)cursorOnBlinkOff);
-		else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(cursorOnBlinkOff,4); Wire.endTransmission();}
-		else SPISendBytes(cursorOnBlinkOff, 4);
+	LCDS_STAT_CMD_BYTES(cbSnd);
+	if (m_cBatchDepth == 0) {
+		PortSend(rgbSnd, cbSnd);
+		return;
 	}
-		else {
-			//send the command for display and blink on
-			if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)cursorBlinkOn);
-			else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)cursorBlinkOn);
-			else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(cursorBlinkOn,4); Wire.endTransmission();}
-			else SPISendBytes(cursorBlinkOn, 4);
+	//count what the bytes would have cost outside the batch
+	m_cBatchSends += TransCount(cbSnd);
+	while (cbSnd > 0) {
+		uint8_t cbCopy = LCDS_BATCH_MAX - m_cbBatch;
+		if (cbCopy > cbSnd) {
+			cbCopy = cbSnd;
 		}
+		memcpy(m_rgbBatch + m_cbBatch, rgbSnd, cbCopy);
+		m_cbBatch += cbCopy;
+		rgbSnd += cbCopy;
+		cbSnd -= cbCopy;
+		if (m_cbBatch == LCDS_BATCH_MAX) {
+			SendBatch(false);
+		}
+	}
 }
-
 /* ------------------------------------------------------------------- */
-/** void LCDS::DisplayClear()
+/** void LCDS::SendBatch(boolean fAll)
 **
 **	Parameters:
-**		none
+**		fAll - true to send the whole batch buffer, false to send only full transactions
 **
 **	Return Value:
-**		none
+**		None
 **
 **	Errors:
 **		none
 **
 **	Description:
-**		This function clears the display and returns the cursor home
+**		This function sends the content of the batch buffer. On I2C a transaction
+**		holds at most the size set with SetI2CBufLen; when fAll is false the bytes
+**		that would make a shorter last transaction are kept for the next commands.
 **
 -----------------------------------------------------------------------*/
-void LCDS::DisplayClear() {
-	uint8_t dispClr[] = {ESC, BRACKET, '0', DISP_CLR_CMD, 0};
-	//clear the display and returns the cursor home
-	if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)dispClr);
-	else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)dispClr);
-	else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(dispClr,4); Wire.endTransmission();}
-	else SPISendBytes(dispClr, 4);
+void LCDS::SendBatch(boolean fAll) {
+	uint8_t cbSnd = m_cbBatch;
+	if (!fAll) {
+		cbSnd -= m_cbBatch % FrameLen();
+	}
+	if (cbSnd > 0) {
+		PortSend(m_rgbBatch, cbSnd);
+		m_cBatchTrans += TransCount(cbSnd);
+		m_cbBatch -= cbSnd;
+		memmove(m_rgbBatch, m_rgbBatch + cbSnd, m_cbBatch);
+	}
 }
-
 /* ------------------------------------------------------------------- */
-/** uint8_t  LCDS::WriteStringAtPos(uint8_t idxLine, uint8_t idxPos, char* strLn)
-**
-**	Parameters:
-**		idxLine - the line where the string is written: 0 or 1
-**		idxPos  - the start column for the string to be written:0 to 39
-**		strLn   - the string to be written
-**
-**	Return Value:
-**		uint8_t 
-**					- LCDS_ERR_SUCCESS - The action completed successfully
-**					- a combination of the following errors(OR-ed): 
-**						- LCDS_ERR_ARG_COL_RANGE - The argument is not within 0, 39 range
-**						- LCDS_ERR_ARG_ROW_RANGE - The argument is not within 0, 2 range
-**
-**	Errors:
-**		see returned values
+/** uint8_t LCDS::FrameLen()
+**	uint8_t LCDS::TransCount(uint8_t cbSnd)
 **
 **	Description:
-**		This function writes a string at a specified position	
+**		FrameLen returns the number of bytes sent in one transaction of a batch:
+**		the Wire buffer size on I2C, the whole batch buffer on the other ports.
+**		TransCount returns the number of transactions needed for cbSnd bytes.
 **
 -----------------------------------------------------------------------*/
-uint8_t LCDS::WriteStringAtPos(uint8_t idxRow, uint8_t idxCol, char* strLn) {
-	int i;
-	int j;
-	uint8_t bResult = LCDS_ERR_SUCCESS;
-	if (idxRow < 0 || idxRow > 2){
-		bResult |= LCDS_ERR_ARG_ROW_RANGE;
-	}
-	if (idxCol < 0 || idxCol > 39){
-		bResult |= LCDS_ERR_ARG_COL_RANGE;
+uint8_t LCDS::FrameLen() {
+	if (m_accessType == PAR_ACCESS_I2C && m_cbI2CBuf < LCDS_BATCH_MAX) {
+		return m_cbI2CBuf;
 	}
-	if (bResult == LCDS_ERR_SUCCESS){
-		//separate the position digits in order to send them, useful when the position is greater than 10
-		uint8_t firstDigit 		= idxCol % 10;
-		uint8_t secondDigit 	= idxCol / 10;
-		uint8_t length 			= strlen(strLn);
-		uint8_t lengthToPrint   = length + idxCol;
-		uint8_t stringToSend[]  = {ESC, BRACKET, idxRow + '0', ';', secondDigit + '0', firstDigit + '0', CURSOR_POS_CMD, 0};
+	return LCDS_BATCH_MAX;
+}
 
-		if (lengthToPrint > 40) {
-			//truncate the lenght of the string 
-			//if it's greater than the positions number of a line
-			length = 40 - idxCol;
-		}
-		if (m_accessType == PAR_ACCESS_UART1){
-			Serial.write((char*)stringToSend);
-			Serial.write(strLn);
-		}
-		else if (m_accessType == PAR_ACCESS_UART2){
-			Serial1.write((char*)stringToSend);
-			Serial1.write(strLn);
-		}
-		else if(m_accessType == PAR_ACCESS_I2C){
-		//The wire library for I2C uses a 32byte buffer to send, so we have to send less than 30 at a time for each transmission
-			Wire.beginTransmission(0x48);
-			Wire.write(stringToSend,7);
-			Wire.endTransmission();
-			if(length<30){
-				Wire.beginTransmission(0x48);
-				Wire.write((byte *)strLn, length);
-				Wire.endTransmission();
-				}
-			else
-				for (int i = 0; i<=(length/30); i++)
-				{
-					Wire.beginTransmission(0x48);
-					if (i==length/30) Wire.write((byte *)(strLn+i*30),length%30);//Last few bytes (not a full 30)
-					else Wire.write((byte *)(strLn+i*30), 30);
-					Wire.endTransmission();
-				}
-			}
-		else {//If SPI
-			SPISendBytes(stringToSend, 7);
-			SPISendBytes((byte *)strLn, length);
-		}
+uint8_t LCDS::TransCount(uint8_t cbSnd) {
+	if (m_accessType == PAR_ACCESS_I2C) {
+		return (cbSnd + m_cbI2CBuf - 1) / m_cbI2CBuf;
 	}
-	return bResult;
+	return 1;
 }
 /* ------------------------------------------------------------------- */
-/** uint8_t  LCDS::DisplayScroll(boolean fDirection, uint8_t idxCol)
+/** void LCDS::SetI2CBufLen(uint8_t cbBuf)
 **
 **	Parameters:
-**		Direction - true for scroll right, false for left
-**		idxCol	- parameter indicating the number of columns to scroll the text
+**		cbBuf - the number of bytes the Wire library can send in one transmission
 **
 **	Return Value:
-**		uint8_t 
-**					- LCDS_ERR_SUCCESS - The action completed successfully 
-**					- LCDS_ERR_ARG_COL_RANGE - The argument is not within 0, 39 range
+**		none
 **
 **	Errors:
 **		none
 **
 **	Description:
-**		This function scrolls left or right the display	with a specified number of columns
+**		This function sets the size of the I2C transmissions. The default is the
+**		LCDS_I2C_BUF_LEN bytes buffer of the standard Wire library; it can be raised
+**		for Wire implementations with a bigger buffer.
 **
 -----------------------------------------------------------------------*/
-uint8_t LCDS::DisplayScroll(boolean fDirection, uint8_t idxCol) {
-	uint8_t bResult;
-	if (idxCol >= 0 && idxCol <= 39){
-		//separate the position digits in order to send them, useful when the position is greater than 10
-		uint8_t firstDigit 		= idxCol % 10;
-		uint8_t secondDigit 	= idxCol / 10;
-		uint8_t rScroll[]     	= {ESC, BRACKET, secondDigit + '0', firstDigit + '0', RSCROLL_CMD, 0};
-		uint8_t lScroll[]       = {ESC, BRACKET, secondDigit + '0', firstDigit + '0', LSCROLL_CMD, 0};
-		DisplayMode(true);
-		if (fDirection) {
-			//scroll right with idxCol columns
-			if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)rScroll);
-			else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)rScroll);
-				else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(rScroll,5); Wire.endTransmission();}
-			else SPISendBytes(rScroll, 5);
-		}
-		else {
-			//scroll left with idxCol columns
-			if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)lScroll);
-			else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)lScroll);
-			else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(lScroll,5); Wire.endTransmission();}
-			else SPISendBytes(lScroll, 5);
-		}
-		bResult = LCDS_ERR_SUCCESS;
-	}
-	else {
-		bResult = LCDS_ERR_ARG_COL_RANGE;
-	}
-	return bResult;
- }
+void LCDS::SetI2CBufLen(uint8_t cbBuf) {
+	m_cbI2CBuf = (cbBuf > 0) ? cbBuf : LCDS_I2C_BUF_LEN;
+}
 /* ------------------------------------------------------------------- */
-/** void  LCDS::SaveCursor()
+/** void LCDS::SetSPIBurst(boolean fBurst, uint8_t usByteGap)
 **
 **	Parameters:
-**		none
-**		
+**		fBurst - true to send each transaction with one buffer transfer of DSPI
+**		usByteGap - the time to wait between two bytes, in us, 0 for none
 **
 **	Return Value:
 **		none
@@ -391,121 +382,185 @@ uint8_t LCDS::DisplayScroll(boolean fDirection, uint8_t idxCol) {
 **		none
 **
 **	Description:
-**		This function saves the current position of the cursor
+**		By default each SPI transaction, e.g. a whole batch, is handed to DSPI in
+**		one buffer transfer, which keeps the transmit FIFO of the port full with
+**		the chip select held low. Without burst, or with a gap for a display that
+**		misses bytes sent back to back, the bytes are sent one by one.
 **
 -----------------------------------------------------------------------*/
-void LCDS::SaveCursor(){
-	uint8_t saveCursor[] = {ESC, BRACKET, '0', CURSOR_SAVE_CMD, 0};
-	//send the save cursor position command
-	if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)saveCursor);
-	else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)saveCursor);
-	else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(saveCursor,4); Wire.endTransmission();}
-	else SPISendBytes(saveCursor, 4);
+void LCDS::SetSPIBurst(boolean fBurst, uint8_t usByteGap) {
+	m_fSPIBurst = fBurst;
+	m_usSPIGap = usByteGap;
 }
 /* ------------------------------------------------------------------- */
-/** void  LCDS::RestoreCursor()
+/** void LCDS::BeginBatch()
 **
 **	Parameters:
 **		none
-**		
 **
 **	Return Value:
-**		none
+**		None
 **
 **	Errors:
 **		none
 **
 **	Description:
-**		This function restores the previously saved position of the cursor
+**		This function starts collecting the following commands, so that they are sent
+**		in as few transactions as possible: one SPI chip select window or one UART
+**		write for each LCDS_BATCH_MAX bytes, full I2C transmissions. Batches can be
+**		nested, the bytes are sent by the Flush matching the outermost BeginBatch.
 **
 -----------------------------------------------------------------------*/
-void LCDS::RestoreCursor(){
-	uint8_t restCursor[] = {ESC, BRACKET, '0', CURSOR_RSTR_CMD, 0};
-	//send the restore cursor position command
-	if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)restCursor);
-	else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)restCursor);
-	else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(restCursor,4); Wire.endTransmission();}
-	else SPISendBytes(restCursor, 4);
+void LCDS::BeginBatch() {
+	if (m_cBatchDepth == 0) {
+		m_fTxqDropped = false;
+	}
+	m_cBatchDepth++;
 }
-
 /* ------------------------------------------------------------------- */
-/** void  LCDS::DisplayMode(boolean charNumber)
+/** uint16_t LCDS::Flush()
 **
 **	Parameters:
-**		charNumber - parameter for selecting the wrapping type of the line: to 16 or 40 characters
-**		
+**		none
 **
 **	Return Value:
-**		none
+**		uint16_t - the number of transactions saved by the batch, 0 for a nested batch
 **
 **	Errors:
 **		none
 **
 **	Description:
-**		This function wraps the line at 16 or 40 characters
+**		This function ends a batch started with BeginBatch and sends the buffered bytes
 **
 -----------------------------------------------------------------------*/
-void LCDS::DisplayMode(boolean charNumber){
-	uint8_t dispMode16[] = {ESC, BRACKET, '0', DISP_MODE_CMD, 0};
-	uint8_t dispMode40[] = {ESC, BRACKET, '1', DISP_MODE_CMD, 0};
-	if (charNumber){
-		//wrap line at 16 characters
-		if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)dispMode16);
-		else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)dispMode16);
-		else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(dispMode16,4); Wire.endTransmission();}
-		else SPISendBytes(dispMode16, 4);
+uint16_t LCDS::Flush() {
+	uint16_t cSaved = 0;
+	if (m_cBatchDepth > 1) {
+		m_cBatchDepth--;
 	}
-	else{
-		//wrap line at 40 characters
-		if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)dispMode40);
-		else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)dispMode40);
-		else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(dispMode40,4); Wire.endTransmission();}
-		else SPISendBytes(dispMode40, 4);
+	else {
+		//the last bytes still belong to the batch, which is then complete
+		SendBatch(true);
+		m_cBatchDepth = 0;
+		TxqPublish();
+		if (m_cBatchSends > m_cBatchTrans) {
+			cSaved = m_cBatchSends - m_cBatchTrans;
+		}
+		m_cTransSaved += cSaved;
+		m_cBatchSends = 0;
+		m_cBatchTrans = 0;
 	}
+	return cSaved;
 }
 /* ------------------------------------------------------------------- */
-/** uint8_t  LCDS::EraseInLine(uint8_t eraseParam)
+/** uint32_t LCDS::GetTransSaved()
+**
+**	Return Value:
+**		uint32_t - the number of transactions saved by batching since Begin
+**
+-----------------------------------------------------------------------*/
+uint32_t LCDS::GetTransSaved() {
+	return m_cTransSaved;
+}
+/* ------------------------------------------------------------------- */
+/** void LCDS::PortSend(const uint8_t* rgbSnd, uint8_t cbSnd)
 **
 **	Parameters:
-**		eraseParam - the selection of erasing operation: from current position, entire line, from the beginning of the line
-**				   0 = current position to end of line
-**		           1 = start of line to current position
-**				   2 = entire line
+**		rgbSnd - the bytes to be sent to the display
+**		cbSnd - the number of bytes to be sent
 **
 **	Return Value:
-**		uint8_t 
-**					- LCDS_ERR_SUCCESS - The action completed successfully 
-**					- LCDS_ERR_ARG_ERASE_OPTIONS - The argument is not within 0, 2 range
+**		None
 **
 **	Errors:
 **		none
 **
 **	Description:
-**		This function erases characters from a line
+**		This function sends one transaction to the display. In asynchronous mode the
+**		bytes are added to the transmit queue instead, and sent later by Poll. When
+**		the queue is full the function either polls until there is room or drops the
+**		command, as selected with AsyncEnable. Poll sees the bytes of a command only
+**		once the command is complete, and those of a batch only at its outermost Flush,
+**		so a drop removes what was queued of them, and the rest of a batch is dropped
+**		too: the display never gets a part of an escape sequence. After a drop the
+**		shadow and the state mirror are invalidated, since the display did not get
+**		what they hold.
 **
 -----------------------------------------------------------------------*/
-uint8_t LCDS::EraseInLine(uint8_t eraseParam){
-	uint8_t bResult;
-	if (eraseParam >= 0 && eraseParam <= 2){
-		uint8_t eraseMode[] = {ESC, BRACKET, (char)eraseParam + '0', ERASE_INLINE_CMD, 0};
-		//send command for erasing characters according to the eraseParam
-		if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)eraseMode);
-		else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)eraseMode);
-		else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(eraseMode,4); Wire.endTransmission();}
-		else SPISendBytes(eraseMode, 4);
-		bResult = LCDS_ERR_SUCCESS;
+void LCDS::PortSend(const uint8_t* rgbSnd, uint8_t cbSnd) {
+	LCDS_STAT_CMD_TRANS(cbSnd);
+	if (!m_fAsync) {
+		PortWrite(rgbSnd, cbSnd);
+		return;
 	}
-	else {
-		bResult = LCDS_ERR_ARG_ERASE_OPTIONS;
+	if (m_cBatchDepth == 0) {
+		//a new command
+		m_fTxqDropped = false;
+	}
+	else if (m_fTxqDropped) {
+		//an earlier part of the batch was dropped
+		return;
+	}
+	uint16_t cbPend = (m_ibTxqPend - m_ibTxqTail) & (LCDS_TXQ_SIZE - 1);
+	if (cbSnd > LCDS_TXQ_SIZE - 1 - cbPend) {
+		if (m_modeTxqFull == LCDS_TXQ_DROP) {
+			//Poll has not seen the bytes of the command, take them back with their slow commands
+			uint16_t ibTail = m_ibTxqTail;
+			uint16_t cbDepth = (m_ibTxqHead - ibTail) & (LCDS_TXQ_SIZE - 1);
+			while (m_imrkHead != m_imrkTail &&
+				((m_rgmrkTxq[(m_imrkHead - 1) & (LCDS_TXQ_MARKS - 1)].ibEnd - ibTail) & (LCDS_TXQ_SIZE - 1)) > cbDepth) {
+				m_imrkHead = (m_imrkHead - 1) & (LCDS_TXQ_MARKS - 1);
+			}
+			m_ibTxqPend = m_ibTxqHead;
+			m_fTxqDropped = true;
+			m_cTxqDrop++;
+			ForceResync();
+			return;
+		}
+		while (GetQueueDepth() > 0 && cbSnd > LCDS_TXQ_SIZE - 1 - GetQueueDepth()) {
+			Poll();
+		}
+		if (cbSnd > LCDS_TXQ_SIZE - 1) {
+			//larger than the whole queue, send it after the queued bytes
+			PortWrite(rgbSnd, cbSnd);
+			return;
+		}
+	}
+	uint16_t ibPend = m_ibTxqPend;
+	for (uint8_t ib = 0; ib < cbSnd; ib++) {
+		m_rgbTxq[ibPend] = rgbSnd[ib];
+		ibPend = (ibPend + 1) & (LCDS_TXQ_SIZE - 1);
+	}
+	m_ibTxqPend = ibPend;
+	if (m_cBatchDepth == 0 || m_modeTxqFull == LCDS_TXQ_BLOCK) {
+		//a blocked batch is published as it goes, Poll has to make room for the rest
+		TxqPublish();
 	}
-	return bResult;
 }
 /* ------------------------------------------------------------------- */
-/** void  LCDS::EraseChars(uint8_t charsNumber)
+/** void LCDS::TxqPublish()
+**
+**	Description:
+**		This function makes the bytes queued since the last call visible to Poll,
+**		all at once, when the command or the batch they belong to is complete
+**
+-----------------------------------------------------------------------*/
+void LCDS::TxqPublish() {
+	m_ibTxqHead = m_ibTxqPend;
+	uint16_t cbDepth = GetQueueDepth();
+	if (cbDepth > m_cbTxqHigh) {
+		m_cbTxqHigh = cbDepth;
+	}
+}
+/* ------------------------------------------------------------------- */
+/** void LCDS::AsyncEnable(boolean fEnable, uint8_t modeFull, uint8_t cbPoll)
 **
 **	Parameters:
-**		charsNumber - the number of characters to be erased
-**		
+**		fEnable - true to queue the bytes and return at once, false to send them directly
+**		modeFull - what to do when the queue is full:
+**					LCDS_TXQ_BLOCK - send queued bytes until there is room
+**					LCDS_TXQ_DROP - drop the command, or the whole batch it is a part of
+**		cbPoll - the maximum number of bytes sent by each call of Poll
 **
 **	Return Value:
 **		none
@@ -514,46 +569,108 @@ uint8_t LCDS::EraseInLine(uint8_t eraseParam){
 **		none
 **
 **	Description:
-**		This function erases a number of characters starting at the current position
+**		This function selects the asynchronous send mode. The commands are then stored
+**		in a LCDS_TXQ_SIZE bytes queue, which is drained by Poll. Poll has to be called
+**		from loop() or from a periodic interrupt service routine, e.g. one registered
+**		with attachCoreTimerService. Turning the mode off sends the queued bytes first.
+**		In LCDS_TXQ_DROP mode a batch is queued only if it fits in the queue at its
+**		Flush, so a batch larger than the queue is always dropped.
 **
 -----------------------------------------------------------------------*/
-void LCDS::EraseChars(uint8_t charsNumber){
-	uint8_t eraseChars[] = {ESC, BRACKET, (char)charsNumber + '0', ERASE_FIELD_CMD, 0};
-	if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)eraseChars);
-	else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)eraseChars);
-	else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(eraseChars,4); Wire.endTransmission();}
-	else SPISendBytes(eraseChars, 4);
+void LCDS::AsyncEnable(boolean fEnable, uint8_t modeFull, uint8_t cbPoll) {
+	if (!fEnable) {
+		TxqPublish();
+		while (GetQueueDepth() > 0 || m_imrkHead != m_imrkTail) {
+			Poll();
+		}
+	}
+	m_modeTxqFull = modeFull;
+	m_cbPoll = (cbPoll > 0) ? cbPoll : 1;
+	m_fAsync = fEnable;
 }
 /* ------------------------------------------------------------------- */
-/** void  LCDS::Reset()
+/** uint16_t LCDS::Poll()
 **
 **	Parameters:
 **		none
-**		
 **
 **	Return Value:
-**		none
+**		uint16_t - the number of bytes still in the queue
 **
 **	Errors:
 **		none
 **
 **	Description:
-**		This function cycles power of LCDS
+**		This function sends up to cbPoll bytes of the transmit queue in one transaction,
+**		never more than the I2C buffer size on I2C. It may be called from an interrupt
+**		service routine; a call that interrupts another Poll returns at once.
+**		A transaction stops at the end of a slow command, whose settle time starts
+**		then; the queue is held until the device is done with it.
 **
 -----------------------------------------------------------------------*/
-void LCDS::Reset(){
-	uint8_t reset[] = {ESC, BRACKET, '0', RST_CMD, 0};
-	if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)reset);
-	else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)reset);
-	else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(reset,4); Wire.endTransmission();}
-	else SPISendBytes(reset, 4);
+uint16_t LCDS::Poll() {
+	if (m_fPolling) {
+		return GetQueueDepth();
+	}
+	if (IsBusy()) {
+		//the device is processing a slow command
+		return GetQueueDepth();
+	}
+	m_fPolling = true;
+	uint16_t ibTail = m_ibTxqTail;
+	uint16_t ibHead = m_ibTxqHead;
+	boolean fMark = (m_imrkHead != m_imrkTail);
+	uint16_t cbMark = fMark ? (m_rgmrkTxq[m_imrkTail].ibEnd - ibTail) & (LCDS_TXQ_SIZE - 1) : LCDS_TXQ_SIZE;
+	if (ibHead != ibTail && cbMark > 0) {
+		//send the bytes up to the end of the queue buffer or of a slow command, the rest on the next call
+		uint16_t cbSnd = (ibHead > ibTail) ? ibHead - ibTail : LCDS_TXQ_SIZE - ibTail;
+		uint8_t cbMax = (m_accessType == PAR_ACCESS_I2C && m_cbPoll > m_cbI2CBuf) ? m_cbI2CBuf : m_cbPoll;
+		if (cbSnd > cbMax) {
+			cbSnd = cbMax;
+		}
+		if (cbSnd > cbMark) {
+			cbSnd = cbMark;
+		}
+		PortWrite(m_rgbTxq + ibTail, cbSnd);
+		m_ibTxqTail = (ibTail + cbSnd) & (LCDS_TXQ_SIZE - 1);
+		cbMark -= cbSnd;
+	}
+	if (fMark && cbMark == 0) {
+		//the device got the whole slow command
+		BusyStart(m_rgmrkTxq[m_imrkTail].fsPace, m_rgmrkTxq[m_imrkTail].usSettle);
+		m_imrkTail = (m_imrkTail + 1) & (LCDS_TXQ_MARKS - 1);
+	}
+	m_fPolling = false;
+	return GetQueueDepth();
 }
 /* ------------------------------------------------------------------- */
-/** void  LCDS::SaveTWIAddr(uint8_t addrEeprom)
+/** uint16_t LCDS::GetQueueDepth()
+**	uint16_t LCDS::GetQueueHighWater()
+**	uint32_t LCDS::GetQueueDrops()
+**
+**	Return Value:
+**		the number of bytes waiting in the transmit queue, the largest number of
+**		bytes ever waiting in it, and the number of commands dropped because it
+**		was full
+**
+-----------------------------------------------------------------------*/
+uint16_t LCDS::GetQueueDepth() {
+	return (m_ibTxqHead - m_ibTxqTail) & (LCDS_TXQ_SIZE - 1);
+}
+
+uint16_t LCDS::GetQueueHighWater() {
+	return m_cbTxqHigh;
+}
+
+uint32_t LCDS::GetQueueDrops() {
+	return m_cTxqDrop;
+}
+/* ------------------------------------------------------------------- */
+/** void LCDS::Settle(uint8_t fsPace, uint32_t usSettle)
 **
 **	Parameters:
-**		addrEeprom - the location where to save the TWI address
-**		
+**		fsPace - the classes of commands that have to wait, LCDS_PACE_xxx OR-ed
+**		usSettle - the time the device needs, in us
 **
 **	Return Value:
 **		none
@@ -562,215 +679,2132 @@ void LCDS::Reset(){
 **		none
 **
 **	Description:
-**		This function saves a TWI address to an EEPROM memory location
+**		This function is called after a slow command. The time is counted from
+**		when the command leaves: a pending batch is sent first. In asynchronous
+**		mode the end of the command is marked in the queue, and Poll starts the
+**		time when it sends the last byte of the command. Nothing waits here, Pace
+**		waits only when a command that depends on the slow one comes before the
+**		time is over, and Poll holds the queue meanwhile. Only when more than
+**		LCDS_TXQ_MARKS slow commands are queued does this function poll until
+**		the oldest one is sent.
 **
 -----------------------------------------------------------------------*/
-void LCDS::SaveTWIAddr(uint8_t addrEeprom){
-	uint8_t saveAddr[] = {ESC, BRACKET, addrEeprom + '0', TWI_SAVE_ADDR_CMD, 0};
-	if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)saveAddr);
-	else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)saveAddr);
-	else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(saveAddr,4); Wire.endTransmission();}
-	else SPISendBytes(saveAddr, 4);
+void LCDS::Settle(uint8_t fsPace, uint32_t usSettle) {
+	if (m_cDryRun > 0 || usSettle == 0) {
+		return;
+	}
+	SendBatch(true);
+	if (m_fAsync && m_fTxqDropped) {
+		//the slow command was dropped
+		return;
+	}
+	if (m_fAsync && m_ibTxqPend != m_ibTxqTail) {
+		uint8_t imrkNext = (m_imrkHead + 1) & (LCDS_TXQ_MARKS - 1);
+		while (imrkNext == m_imrkTail && GetQueueDepth() > 0) {
+			Poll();
+		}
+		if (imrkNext == m_imrkTail) {
+			//the marks are all in a batch not complete yet, the device waits once for all of them
+			LCDS_TXQ_MARK* pmrk = &m_rgmrkTxq[(m_imrkHead - 1) & (LCDS_TXQ_MARKS - 1)];
+			pmrk->ibEnd = m_ibTxqPend;
+			pmrk->fsPace |= fsPace;
+			pmrk->usSettle += usSettle;
+		}
+		else {
+			m_rgmrkTxq[m_imrkHead].ibEnd = m_ibTxqPend;
+			m_rgmrkTxq[m_imrkHead].fsPace = fsPace;
+			m_rgmrkTxq[m_imrkHead].usSettle = usSettle;
+			m_imrkHead = imrkNext;
+		}
+		return;
+	}
+	BusyStart(fsPace, usSettle);
 }
-
 /* ------------------------------------------------------------------- */
-/** uint8_t  LCDS::SaveBR(uint8_t baudRate)
+/** void LCDS::BusyStart(uint8_t fsPace, uint32_t usSettle)
 **
 **	Parameters:
-**		baudRate - the baud rate value to be saved in the EEPROM memory
-**		
+**		fsPace - the classes of commands that have to wait, LCDS_PACE_xxx OR-ed
+**		usSettle - the time the device needs, in us
+**
+**	Description:
+**		This function starts the time the device needs for a slow command that
+**		was just sent. The device processes the commands in order, so the time
+**		left of a previous slow command is not cut short.
+**
+-----------------------------------------------------------------------*/
+void LCDS::BusyStart(uint8_t fsPace, uint32_t usSettle) {
+	uint32_t usNow = micros();
+	uint32_t usLeft = 0;
+	if (m_fsBusy != 0 && usNow - m_usBusyStart < m_usBusy) {
+		usLeft = m_usBusy - (usNow - m_usBusyStart);
+	}
+	m_fsBusy |= fsPace;
+	m_usBusyStart = usNow;
+	m_usBusy = (usLeft > usSettle) ? usLeft : usSettle;
+}
+/* ------------------------------------------------------------------- */
+/** void LCDS::Pace(uint8_t fsPace)
+**
+**	Parameters:
+**		fsPace - the classes of the command about to be sent, LCDS_PACE_xxx OR-ed
 **
 **	Return Value:
-**		uint8_t 
-**					- LCDS_ERR_SUCCESS - The action completed successfully 
-**					- LCDS_ERR_ARG_BR_RANGE - The argument is not within 0, 6 range
+**		none
 **
 **	Errors:
 **		none
 **
 **	Description:
-**		This function saves the baud rate value to an EEPROM memory location
+**		This function waits until the device is done with the slow commands, if
+**		the command depends on them. In asynchronous mode it returns at once:
+**		Poll holds the queue until the device is done.
 **
 -----------------------------------------------------------------------*/
-uint8_t LCDS::SaveBR(uint8_t baudRate){
-		/*EEPROM based baud rate for USART
-	allowed values:
-	0 -> 2400
-	1 -> 4800
-	2 -> 9600
+void LCDS::Pace(uint8_t fsPace) {
+	if (m_cDryRun > 0 || m_fAsync || !(m_fsBusy & fsPace)) {
+		return;
+	}
+	uint32_t usStart = micros();
+	while (IsBusy()) {
+	}
+	m_usPaceWait += micros() - usStart;
+}
+/* ------------------------------------------------------------------- */
+/** boolean LCDS::IsBusy()
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		boolean - true while the device is processing a slow command
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		The slow commands (DefineUserChar, the character tables, the EEPROM
+**		commands, Reset) return without waiting for the device. Only the next
+**		command that depends on them waits. The application can call this function
+**		to do other work instead, e.g. from loop() before redefining user chars.
+**		In asynchronous mode the time starts when Poll sends the slow command.
+**
+-----------------------------------------------------------------------*/
+boolean LCDS::IsBusy() {
+	if (m_fsBusy != 0 && micros() - m_usBusyStart >= m_usBusy) {
+		m_fsBusy = 0;
+	}
+	return m_fsBusy != 0;
+}
+/* ------------------------------------------------------------------- */
+/** uint32_t LCDS::GetPaceWait()
+**
+**	Return Value:
+**		uint32_t - the time the commands waited for slow commands since Begin, in us
+**
+-----------------------------------------------------------------------*/
+uint32_t LCDS::GetPaceWait() {
+	return m_usPaceWait;
+}
+/* ------------------------------------------------------------------- */
+/** void LCDS::PortWrite(const uint8_t* rgbSnd, uint8_t cbSnd)
+**
+**	Parameters:
+**		rgbSnd - the bytes to be sent to the display
+**		cbSnd - the number of bytes to be sent
+**
+**	Return Value:
+**		None
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function sends an array of bytes to the display in one transaction over
+**		the communication port selected in Begin. It is the only place where the port
+**		is tested. A port can be removed from the build by defining LCDS_NO_DSPI,
+**		LCDS_NO_UART or LCDS_NO_I2C for the whole build, e.g. with -DLCDS_NO_I2C in
+**		the compiler flags, since LCDS.cpp is compiled on its own and a define in
+**		the sketch does not reach it.
+**
+-----------------------------------------------------------------------*/
+void LCDS::PortWrite(const uint8_t* rgbSnd, uint8_t cbSnd) {
+#if defined(LCDS_STATS_ENABLE)
+	uint32_t usStart = micros();
+#endif
+	switch(m_accessType) {
+#if !defined(LCDS_NO_UART)
+		case PAR_ACCESS_UART1:
+			Serial.write(rgbSnd, cbSnd);
+			break;
+		case PAR_ACCESS_UART2:
+			Serial1.write(rgbSnd, cbSnd);
+			break;
+#endif
+#if !defined(LCDS_NO_I2C)
+		case PAR_ACCESS_I2C:
+			I2CSendBytes(rgbSnd, cbSnd);
+			break;
+#endif
+		case PAR_ACCESS_USER:
+			if (m_pfnSend != NULL) {
+				m_pfnSend(m_pvSendCtx, rgbSnd, cbSnd);
+			}
+			break;
+		default:
+			SPISendBytes(rgbSnd, cbSnd);
+			break;
+	}
+#if defined(LCDS_STATS_ENABLE)
+	StatPort(cbSnd, micros() - usStart);
+#endif
+}
+/* ------------------------------------------------------------------- */
+/** boolean LCDS::Stats(LCDS_STATS* pstats, boolean fReset)
+**
+**	Parameters:
+**		pstats - receives the statistics, can be NULL to only reset them
+**		fReset - true to clear the statistics after they are copied
+**
+**	Return Value:
+**		boolean
+**					- true - the statistics were copied
+**					- false - the library was built without LCDS_STATS_ENABLE
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		The statistics are collected only when LCDS_STATS_ENABLE is defined for the
+**		whole build, e.g. with -DLCDS_STATS_ENABLE in the compiler flags, since it
+**		changes the size of the class. Without it the counting code and the counters
+**		are not compiled and this function clears *pstats. Bytes and transactions
+**		are counted for the command that produced them when they are sent or queued,
+**		and for the port when they are put on the bus, so in asynchronous mode the
+**		port counters include the bytes sent by Poll.
+**
+-----------------------------------------------------------------------*/
+boolean LCDS::Stats(LCDS_STATS* pstats, boolean fReset) {
+#if defined(LCDS_STATS_ENABLE)
+	if (pstats != NULL) {
+		memcpy(pstats, &m_stats, sizeof(m_stats));
+	}
+	if (fReset) {
+		memset(&m_stats, 0, sizeof(m_stats));
+	}
+	return true;
+#else
+	(void)fReset;
+	if (pstats != NULL) {
+		memset(pstats, 0, sizeof(LCDS_STATS));
+	}
+	return false;
+#endif
+}
+#if defined(LCDS_STATS_ENABLE)
+/* ------------------------------------------------------------------- */
+/** void LCDS::StatPort(uint8_t cbSnd, uint32_t usSnd)
+**
+**	Parameters:
+**		cbSnd - the number of bytes sent
+**		usSnd - the time taken to send them
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function counts a send on the port selected in Begin. The latency bin
+**		is the number of significant bits of the time in us.
+**
+-----------------------------------------------------------------------*/
+void LCDS::StatPort(uint8_t cbSnd, uint32_t usSnd) {
+	uint8_t idxPort = (m_accessType < LCDS_STAT_PORTS) ? m_accessType : PAR_ACCESS_DSPI0;
+	uint8_t idxBin = 0;
+	m_stats.rgcbPort[idxPort] += cbSnd;
+	m_stats.rgcTransPort[idxPort] += TransCount(cbSnd);
+	while (usSnd >> idxBin != 0 && idxBin < LCDS_STAT_BINS - 1) {
+		idxBin++;
+	}
+	m_stats.rgcLatency[idxPort][idxBin]++;
+	if (usSnd > m_stats.rgusLatencyMax[idxPort]) {
+		m_stats.rgusLatencyMax[idxPort] = usSnd;
+	}
+}
+#endif
+/* ------------------------------------------------------------------- */
+/** void LCDS::SPISendBytes(const uint8_t* dataChars, uint8_t lenght)
+**
+**	Parameters:
+**		dataChars - the string to be sent to SPI
+**		lenght - the lenght of the string to be sent
+**		
+**
+**	Return Value:
+**		None
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function sends an array of characters to the SPI interface using the Arduino standard functions.
+**		The chip select stays low for the whole array, which is sent in one buffer
+**		transfer unless SetSPIBurst asked for single bytes.
+**
+-----------------------------------------------------------------------*/
+void LCDS :: SPISendBytes(const uint8_t* dataChars, uint8_t lenght){
+#if !defined(LCDS_NO_DSPI)
+	if (pdspi != NULL) {
+		digitalWrite(m_SSPin, LOW);
+		if (m_fSPIBurst && m_usSPIGap == 0) {
+			pdspi->transfer(lenght, (uint8_t*)dataChars);
+		}
+		else {
+			for(int i = 0; i < lenght; i++) {
+				if (i > 0 && m_usSPIGap != 0) {
+					delayMicroseconds(m_usSPIGap);
+				}
+				pdspi->transfer(dataChars[i]);
+			}
+		}
+		digitalWrite(m_SSPin, HIGH);
+	}
+#else
+	(void)dataChars;
+	(void)lenght;
+#endif
+}
+/* ------------------------------------------------------------------- */
+/** void LCDS::I2CSendBytes(const uint8_t* dataChars, uint8_t lenght)
+**
+**	Parameters:
+**		dataChars - the string to be sent to I2C
+**		lenght - the lenght of the string to be sent
+**
+**	Return Value:
+**		None
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function sends an array of characters to the display. The Wire library
+**		can only buffer a limited number of bytes, so the array is split into as few
+**		transmissions as possible of the size set with SetI2CBufLen. Every I2C send
+**		goes through this function.
+**
+-----------------------------------------------------------------------*/
+void LCDS::I2CSendBytes(const uint8_t* dataChars, uint8_t lenght){
+#if !defined(LCDS_NO_I2C)
+	while (lenght > 0) {
+		uint8_t cbFrame = (lenght < m_cbI2CBuf) ? lenght : m_cbI2CBuf;
+		Wire.beginTransmission(m_bI2CAddr);
+		Wire.write(dataChars, cbFrame);
+		Wire.endTransmission();
+		dataChars += cbFrame;
+		lenght -= cbFrame;
+	}
+#else
+	(void)dataChars;
+	(void)lenght;
+#endif
+}
+/* ------------------------------------------------------------------- */
+/** void LCDS::DisplaySet(bool setDisplay, bool setBckl)
+**
+**	Parameters:
+**		setDisplay - boolean parameter through which the display is set on or off
+**		setBckl - boolean parameter through which the backlight is set on or off
+**
+**
+**	Return Value:
+**		None
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function turns the display and the backlight on or off, according to the user's selection.
+**		Nothing is sent when the device is known to be in the selected state.
+**
+-----------------------------------------------------------------------*/
+void LCDS::DisplaySet(boolean setDisplay, boolean setBckl) {
+	LCDS_STAT_CMD(LCDS_STAT_DISPLAY_SET);
+	Pace(LCDS_PACE_DDRAM);
+    uint8_t dispBcklOff []  = {ESC, BRACKET, '0', DISP_EN_CMD};
+	uint8_t dispOnBckl[] = { ESC, BRACKET, '1', DISP_EN_CMD };
+	uint8_t dispBcklOn[] = { ESC, BRACKET, '2', DISP_EN_CMD };
+	uint8_t dispOnBcklOn[] = { ESC, BRACKET, '3', DISP_EN_CMD };
+	uint8_t bDispEn = (setDisplay ? 1 : 0) | (setBckl ? 2 : 0);
+	if (bDispEn == m_bDispEn) {
+		//the device is already in this state
+		return;
+	}
+	m_bDispEn = bDispEn;
+	if ((!setDisplay)&&(!setBckl))	{
+		//send the command for both display and backlight off
+		SendBytes(dispBcklOff, sizeof(dispBcklOff));
+	}
+	else if ((setDisplay)&&(!setBckl))	{
+		//send the command for display on and backlight off
+		SendBytes(dispOnBckl, sizeof(dispOnBckl));
+		}
+		else if ((!setDisplay)&&(setBckl))	{
+			//send the command for backlight on and display off
+			SendBytes(dispBcklOn, sizeof(dispBcklOn));
+		}
+			else {
+				//send the command for both display and backlight on
+				SendBytes(dispOnBcklOn, sizeof(dispOnBcklOn));
+			}
+}
+/* ------------------------------------------------------------------- */
+/** void LCDS::CursorModeSet(bool setCursor, bool setBlink)
+**
+**	Parameters:
+**		setCursor - boolean parameter through which the cursor is set on or off
+**		setBlink - boolean parameter through which the blink option is set on or off
+**
+**
+**	Return Value:
+**		None
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function turns the cursor and the blinking option on or off, according to the user's selection.
+**		Nothing is sent when the device is known to be in the selected mode.
+**
+-----------------------------------------------------------------------*/
+void LCDS::CursorModeSet(boolean setCursor, boolean setBlink) {
+	LCDS_STAT_CMD(LCDS_STAT_CURSOR_MODE);
+	Pace(LCDS_PACE_DDRAM);
+	uint8_t cursorOff[]  		  = {ESC, BRACKET, '0', CURSOR_MODE_CMD};
+	uint8_t cursorOnBlinkOff[]    = {ESC, BRACKET, '1', CURSOR_MODE_CMD};
+	uint8_t cursorBlinkOn[]       = {ESC, BRACKET, '2', CURSOR_MODE_CMD};
+	uint8_t modeCrs = !setCursor ? 0 : (!setBlink ? 1 : 2);
+	//a visible cursor has to be where the caller left it
+	m_fCrsShown = setCursor;
+	if (setCursor) {
+		SyncCursor();
+	}
+	if (modeCrs == m_modeCrs) {
+		//the device is already in this mode
+		return;
+	}
+	m_modeCrs = modeCrs;
+	if (!setCursor)	{
+		//send the command for both display and blink off
+		SendBytes(cursorOff, sizeof(cursorOff));
+	}
+	else if ((setCursor)&&(!setBlink)) {
+		//send the command for display on and blink off
+		SendBytes(cursorOnBlinkOff, sizeof(cursorOnBlinkOff));
+	}
+		else {
+			//send the command for display and blink on
+			SendBytes(cursorBlinkOn, sizeof(cursorBlinkOn));
+		}
+}
+
+/* ------------------------------------------------------------------- */
+/** void LCDS::DisplayClear()
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function clears the display and returns the cursor home
+**
+-----------------------------------------------------------------------*/
+void LCDS::DisplayClear() {
+	LCDS_STAT_CMD(LCDS_STAT_CLEAR);
+	Pace(LCDS_PACE_DDRAM);
+	uint8_t dispClr[] = {ESC, BRACKET, '0', DISP_CLR_CMD};
+	//clear the display and returns the cursor home
+	SendBytes(dispClr, sizeof(dispClr));
+	Settle(LCDS_PACE_DDRAM, LCDS_SETTLE_CLEAR_US);
+	memset(m_rgbShadow, ' ', sizeof(m_rgbShadow));
+	memset(m_rgbShadowKnown, 0xFF, sizeof(m_rgbShadowKnown));
+	m_idxRowCrs = 0;
+	m_idxColCrs = 0;
+	m_fCrsKnown = true;
+	m_idxRowDev = 0;
+	m_idxColDev = 0;
+	m_fDevKnown = true;
+	m_idxScroll = 0;
+}
+
+/* ------------------------------------------------------------------- */
+/** uint8_t  LCDS::WriteStringAtPos(uint8_t idxLine, uint8_t idxPos, char* strLn)
+**
+**	Parameters:
+**		idxLine - the line where the string is written: 0 or 1
+**		idxPos  - the start column for the string to be written:0 to 39
+**		strLn   - the string to be written
+**
+**	Return Value:
+**		uint8_t 
+**					- LCDS_ERR_SUCCESS - The action completed successfully
+**					- a combination of the following errors(OR-ed): 
+**						- LCDS_ERR_ARG_COL_RANGE - The argument is not within 0, 39 range
+**						- LCDS_ERR_ARG_ROW_RANGE - The argument is not within 0, 2 range
+**
+**	Errors:
+**		see returned values
+**
+**	Description:
+**		This function writes a string at a specified position	
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::WriteStringAtPos(uint8_t idxRow, uint8_t idxCol, char* strLn) {
+	size_t length = strlen(strLn);
+	//the part after the last column is not written
+	return WriteStringAtPos(idxRow, idxCol, strLn, (length > LCDS_COLS) ? LCDS_COLS : length);
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t  LCDS::WriteStringAtPos(uint8_t idxRow, uint8_t idxCol, const char* pchText, uint8_t cchText)
+**
+**	Parameters:
+**		idxRow  - the line where the string is written: 0 or 1
+**		idxCol  - the start column for the string to be written:0 to 39
+**		pchText - the characters to be written, they do not need to be terminated
+**		cchText - the number of characters
+**
+**	Return Value:
+**		uint8_t 
+**					- LCDS_ERR_SUCCESS - The action completed successfully
+**					- a combination of the following errors(OR-ed): 
+**						- LCDS_ERR_ARG_COL_RANGE - The argument is not within 0, 39 range
+**						- LCDS_ERR_ARG_ROW_RANGE - The argument is not within 0, 2 range
+**
+**	Errors:
+**		see returned values
+**
+**	Description:
+**		This function writes a string at a specified position, without searching
+**		for its end. It can write a part of a longer string.
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::WriteStringAtPos(uint8_t idxRow, uint8_t idxCol, const char* pchText, uint8_t cchText) {
+	LCDS_STAT_CMD(LCDS_STAT_WRITE);
+	uint8_t bResult = LCDS_ERR_SUCCESS;
+	if (idxRow < 0 || idxRow > 2){
+		bResult |= LCDS_ERR_ARG_ROW_RANGE;
+	}
+	if (idxCol < 0 || idxCol > 39){
+		bResult |= LCDS_ERR_ARG_COL_RANGE;
+	}
+	if (bResult == LCDS_ERR_SUCCESS){
+		if (cchText + idxCol > 40) {
+			//truncate the lenght of the string 
+			//if it's greater than the positions number of a line
+			cchText = 40 - idxCol;
+		}
+		WriteCells(idxRow, idxCol, (const uint8_t*)pchText, cchText);
+	}
+	return bResult;
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t  LCDS::WriteNumberAtPos(uint8_t idxRow, uint8_t idxCol, int32_t lValue, uint8_t cchWidth, uint8_t cDecimals)
+**
+**	Parameters:
+**		idxRow    - the line where the number is written: 0 or 1
+**		idxCol    - the start column for the number to be written:0 to 39
+**		lValue    - the number, in units of the last decimal
+**		cchWidth  - the number of columns, filled with spaces before the number
+**		cDecimals - the number of digits after the decimal point, at most LCDS_DECIMALS_MAX
+**
+**	Return Value:
+**		uint8_t 
+**					- LCDS_ERR_SUCCESS - The action completed successfully
+**					- a combination of the following errors(OR-ed): 
+**						- LCDS_ERR_ARG_COL_RANGE - The argument is not within 0, 39 range
+**						- LCDS_ERR_ARG_ROW_RANGE - The argument is not within 0, 2 range
+**
+**	Errors:
+**		see returned values
+**
+**	Description:
+**		This function writes a decimal number without sprintf and without floating
+**		point: 2155 with 1 decimal is written as 215.5, -5 with 2 decimals as -0.05.
+**		A number wider than cchWidth takes the columns it needs. As for the strings,
+**		only the characters that changed are sent, so a counter redrawn at the same
+**		position costs little more than its digits that changed.
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::WriteNumberAtPos(uint8_t idxRow, uint8_t idxCol, int32_t lValue, uint8_t cchWidth, uint8_t cDecimals) {
+	uint8_t rgbText[LCDS_COLS];
+	uint8_t ib = LCDS_COLS;
+	uint8_t cDigit = 0;
+	uint32_t dwValue = (lValue < 0) ? 0 - (uint32_t)lValue : (uint32_t)lValue;
+	if (cDecimals > LCDS_DECIMALS_MAX) {
+		cDecimals = LCDS_DECIMALS_MAX;
+	}
+	if (cchWidth > LCDS_COLS) {
+		cchWidth = LCDS_COLS;
+	}
+	//digits from the last one, with at least one before the decimal point
+	do {
+		if (cDigit == cDecimals && cDecimals > 0) {
+			rgbText[--ib] = '.';
+		}
+		rgbText[--ib] = '0' + dwValue % 10;
+		dwValue /= 10;
+		cDigit++;
+	} while (dwValue != 0 || cDigit <= cDecimals);
+	if (lValue < 0) {
+		rgbText[--ib] = '-';
+	}
+	while (LCDS_COLS - ib < cchWidth) {
+		rgbText[--ib] = ' ';
+	}
+	return WriteStringAtPos(idxRow, idxCol, (const char*)rgbText + ib, LCDS_COLS - ib);
+}
+/* ------------------------------------------------------------------- */
+/** size_t  LCDS::write(uint8_t bChar)
+**	size_t  LCDS::write(const uint8_t* rgbText, size_t cbText)
+**
+**	Parameters:
+**		bChar - the character to be written
+**		rgbText - the characters to be written
+**		cbText - the number of characters
+**
+**	Return Value:
+**		size_t - the number of characters written
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		These functions write at the cursor, which SetPos moves. They make the
+**		print functions of the Print class available: print("Temp "), print(t),
+**		print(v, HEX). The characters are written as by WriteStringAtPos, straight
+**		from the buffer of the caller, and control characters are not interpreted.
+**		When the cursor position is not known the characters are sent anyway and
+**		the shadow is invalidated.
+**
+-----------------------------------------------------------------------*/
+size_t LCDS::write(uint8_t bChar) {
+	return write(&bChar, 1);
+}
+
+size_t LCDS::write(const uint8_t* rgbText, size_t cbText) {
+	LCDS_STAT_CMD(LCDS_STAT_WRITE);
+	Pace(LCDS_PACE_DDRAM);
+	size_t ib = 0;
+	BeginBatch();
+	while (ib < cbText) {
+		uint8_t cb = (cbText - ib > LCDS_COLS) ? LCDS_COLS : cbText - ib;
+		if (m_fCrsKnown) {
+			WriteCells(m_idxRowCrs, m_idxColCrs, rgbText + ib, cb);
+		}
+		else {
+			SendBytes(rgbText + ib, cb);
+			ShadowInvalidate();
+		}
+		ib += cb;
+	}
+	Flush();
+	return cbText;
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t  LCDS::DisplayScroll(boolean fDirection, uint8_t idxCol)
+**
+**	Parameters:
+**		Direction - true for scroll right, false for left
+**		idxCol	- parameter indicating the number of columns to scroll the text
+**
+**	Return Value:
+**		uint8_t 
+**					- LCDS_ERR_SUCCESS - The action completed successfully 
+**					- LCDS_ERR_ARG_COL_RANGE - The argument is not within 0, 39 range
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function scrolls left or right the display	with a specified number of columns.
+**		The display wraps at 16 columns afterwards. Scrolling by 0 columns sends only
+**		the display mode, if it changes.
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::DisplayScroll(boolean fDirection, uint8_t idxCol) {
+	LCDS_STAT_CMD(LCDS_STAT_SCROLL);
+	Pace(LCDS_PACE_DDRAM);
+	uint8_t bResult;
+	if (idxCol >= 0 && idxCol <= 39){
+		DisplayMode(true);
+		if (idxCol > 0) {
+			if (m_idxScroll != LCDS_STATE_UNKNOWN) {
+				//scrolling right shows the columns before the first one
+				m_idxScroll = fDirection ? (m_idxScroll + LCDS_COLS - idxCol) % LCDS_COLS : (m_idxScroll + idxCol) % LCDS_COLS;
+			}
+			//separate the position digits in order to send them, the tens are sent only when not 0
+			uint8_t scroll[5];
+			uint8_t cbSnd = 0;
+			scroll[cbSnd++] = ESC;
+			scroll[cbSnd++] = BRACKET;
+			if (idxCol >= 10) {
+				scroll[cbSnd++] = idxCol / 10 + '0';
+			}
+			scroll[cbSnd++] = idxCol % 10 + '0';
+			scroll[cbSnd++] = fDirection ? RSCROLL_CMD : LSCROLL_CMD;
+			SendBytes(scroll, cbSnd);
+		}
+		bResult = LCDS_ERR_SUCCESS;
+	}
+	else {
+		bResult = LCDS_ERR_ARG_COL_RANGE;
+	}
+	return bResult;
+ }
+/* ------------------------------------------------------------------- */
+/** void  LCDS::SaveCursor()
+**
+**	Parameters:
+**		none
+**		
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function saves the current position of the cursor
+**
+-----------------------------------------------------------------------*/
+void LCDS::SaveCursor(){
+	LCDS_STAT_CMD(LCDS_STAT_CURSOR_SAVE);
+	Pace(LCDS_PACE_DDRAM);
+	uint8_t saveCursor[] = {ESC, BRACKET, '0', CURSOR_SAVE_CMD};
+	SyncCursor();
+	//send the save cursor position command
+	SendBytes(saveCursor, sizeof(saveCursor));
+	m_idxRowSaved = m_idxRowCrs;
+	m_idxColSaved = m_idxColCrs;
+	m_fSavedKnown = m_fCrsKnown;
+}
+/* ------------------------------------------------------------------- */
+/** void  LCDS::RestoreCursor()
+**
+**	Parameters:
+**		none
+**		
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function restores the previously saved position of the cursor
+**
+-----------------------------------------------------------------------*/
+void LCDS::RestoreCursor(){
+	LCDS_STAT_CMD(LCDS_STAT_CURSOR_SAVE);
+	Pace(LCDS_PACE_DDRAM);
+	uint8_t restCursor[] = {ESC, BRACKET, '0', CURSOR_RSTR_CMD};
+	if (m_fSavedKnown && m_fDevKnown && m_idxRowDev == m_idxRowSaved && m_idxColDev == m_idxColSaved) {
+		//the device cursor is already at the saved position
+		m_idxRowCrs = m_idxRowSaved;
+		m_idxColCrs = m_idxColSaved;
+		m_fCrsKnown = true;
+		return;
+	}
+	//send the restore cursor position command
+	SendBytes(restCursor, sizeof(restCursor));
+	m_idxRowCrs = m_idxRowSaved;
+	m_idxColCrs = m_idxColSaved;
+	m_fCrsKnown = m_fSavedKnown;
+	m_idxRowDev = m_idxRowSaved;
+	m_idxColDev = m_idxColSaved;
+	m_fDevKnown = m_fSavedKnown;
+}
+
+/* ------------------------------------------------------------------- */
+/** void  LCDS::DisplayMode(boolean charNumber)
+**
+**	Parameters:
+**		charNumber - parameter for selecting the wrapping type of the line: to 16 or 40 characters
+**		
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function wraps the line at 16 or 40 characters. Nothing is sent when the
+**		device is known to wrap at the selected column.
+**
+-----------------------------------------------------------------------*/
+void LCDS::DisplayMode(boolean charNumber){
+	LCDS_STAT_CMD(LCDS_STAT_DISPLAY_MODE);
+	Pace(LCDS_PACE_DDRAM);
+	uint8_t dispMode16[] = {ESC, BRACKET, '0', DISP_MODE_CMD};
+	uint8_t dispMode40[] = {ESC, BRACKET, '1', DISP_MODE_CMD};
+	if (m_colWrap == (charNumber ? 16 : 40)) {
+		//the device already wraps at this column, e.g. when called by DisplayScroll
+		return;
+	}
+	if (charNumber){
+		//wrap line at 16 characters
+		m_colWrap = 16;
+		SendBytes(dispMode16, sizeof(dispMode16));
+	}
+	else{
+		//wrap line at 40 characters
+		m_colWrap = 40;
+		SendBytes(dispMode40, sizeof(dispMode40));
+	}
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t  LCDS::EraseInLine(uint8_t eraseParam)
+**
+**	Parameters:
+**		eraseParam - the selection of erasing operation: from current position, entire line, from the beginning of the line
+**				   0 = current position to end of line
+**		           1 = start of line to current position
+**				   2 = entire line
+**
+**	Return Value:
+**		uint8_t 
+**					- LCDS_ERR_SUCCESS - The action completed successfully 
+**					- LCDS_ERR_ARG_ERASE_OPTIONS - The argument is not within 0, 2 range
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function erases characters from a line
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::EraseInLine(uint8_t eraseParam){
+	LCDS_STAT_CMD(LCDS_STAT_ERASE);
+	Pace(LCDS_PACE_DDRAM);
+	uint8_t bResult;
+	if (eraseParam >= 0 && eraseParam <= 2){
+		uint8_t eraseMode[] = {ESC, BRACKET, (char)eraseParam + '0', ERASE_INLINE_CMD};
+		SyncCursor();
+		//send command for erasing characters according to the eraseParam
+		SendBytes(eraseMode, sizeof(eraseMode));
+		if (eraseParam == 0)		ShadowErase(m_idxColCrs, LCDS_COLS - 1);
+		else if (eraseParam == 1)	ShadowErase(0, m_idxColCrs);
+		else						ShadowErase(0, LCDS_COLS - 1);
+		bResult = LCDS_ERR_SUCCESS;
+	}
+	else {
+		bResult = LCDS_ERR_ARG_ERASE_OPTIONS;
+	}
+	return bResult;
+}
+/* ------------------------------------------------------------------- */
+/** void  LCDS::EraseChars(uint8_t charsNumber)
+**
+**	Parameters:
+**		charsNumber - the number of characters to be erased
+**		
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function erases a number of characters starting at the current position
+**
+-----------------------------------------------------------------------*/
+void LCDS::EraseChars(uint8_t charsNumber){
+	LCDS_STAT_CMD(LCDS_STAT_ERASE);
+	Pace(LCDS_PACE_DDRAM);
+	uint8_t eraseChars[7];
+	uint8_t cbSnd = 0;
+	eraseChars[cbSnd++] = ESC;
+	eraseChars[cbSnd++] = BRACKET;
+	//the number of chars is sent in decimal, without leading zeros
+	if (charsNumber >= 100) {
+		eraseChars[cbSnd++] = charsNumber / 100 + '0';
+	}
+	if (charsNumber >= 10) {
+		eraseChars[cbSnd++] = (charsNumber / 10) % 10 + '0';
+	}
+	eraseChars[cbSnd++] = charsNumber % 10 + '0';
+	eraseChars[cbSnd++] = ERASE_FIELD_CMD;
+	SyncCursor();
+	SendBytes(eraseChars, cbSnd);
+	if (charsNumber > 0) {
+		ShadowErase(m_idxColCrs, (m_idxColCrs + charsNumber - 1 < LCDS_COLS) ? m_idxColCrs + charsNumber - 1 : LCDS_COLS - 1);
+	}
+}
+/* ------------------------------------------------------------------- */
+/** void  LCDS::Reset()
+**
+**	Parameters:
+**		none
+**		
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function cycles power of LCDS
+**
+-----------------------------------------------------------------------*/
+void LCDS::Reset(){
+	LCDS_STAT_CMD(LCDS_STAT_RESET);
+	Pace(LCDS_PACE_ALL);
+	uint8_t reset[] = {ESC, BRACKET, '0', RST_CMD};
+	SendBytes(reset, sizeof(reset));
+	ForceResync();
+	Settle(LCDS_PACE_ALL, LCDS_SETTLE_RESET_US);
+}
+/* ------------------------------------------------------------------- */
+/** void  LCDS::SaveTWIAddr(uint8_t addrEeprom)
+**
+**	Parameters:
+**		addrEeprom - the TWI address to be saved, e.g. 0x48
+**		
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function saves a TWI address to an EEPROM memory location
+**
+-----------------------------------------------------------------------*/
+void LCDS::SaveTWIAddr(uint8_t addrEeprom){
+	LCDS_STAT_CMD(LCDS_STAT_EEPROM);
+	Pace(LCDS_PACE_EEPROM);
+	uint8_t saveAddr[6];
+	uint8_t cbSnd = 0;
+	saveAddr[cbSnd++] = ESC;
+	saveAddr[cbSnd++] = BRACKET;
+	//the address is sent in decimal, without leading zeros
+	if (addrEeprom >= 100) {
+		saveAddr[cbSnd++] = addrEeprom / 100 + '0';
+	}
+	if (addrEeprom >= 10) {
+		saveAddr[cbSnd++] = (addrEeprom / 10) % 10 + '0';
+	}
+	saveAddr[cbSnd++] = addrEeprom % 10 + '0';
+	saveAddr[cbSnd++] = TWI_SAVE_ADDR_CMD;
+	SendBytes(saveAddr, cbSnd);
+	Settle(LCDS_PACE_EEPROM, LCDS_SETTLE_EEPROM_US);
+}
+
+/* ------------------------------------------------------------------- */
+/** uint8_t  LCDS::SaveBR(uint8_t baudRate)
+**
+**	Parameters:
+**		baudRate - the baud rate value to be saved in the EEPROM memory
+**		
+**
+**	Return Value:
+**		uint8_t 
+**					- LCDS_ERR_SUCCESS - The action completed successfully 
+**					- LCDS_ERR_ARG_BR_RANGE - The argument is not within 0, 6 range
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function saves the baud rate value to an EEPROM memory location
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::SaveBR(uint8_t baudRate){
+	LCDS_STAT_CMD(LCDS_STAT_EEPROM);
+	Pace(LCDS_PACE_EEPROM);
+		/*EEPROM based baud rate for USART
+	allowed values:
+	0 -> 2400
+	1 -> 4800
+	2 -> 9600
 	3 -> 19200
 	4 -> 38400
 	5 -> 76800
 	*/
 	uint8_t bResult;
-	if (baudRate >= 0 && baudRate <= 6){
-		uint8_t saveBR[] = {ESC, BRACKET, baudRate + '0', BR_SAVE_CMD, 0};
-		if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)saveBR);
-		else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)saveBR);
-		else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(saveBR,4); Wire.endTransmission();}
-		else SPISendBytes(saveBR, 4);
+	if (baudRate >= 0 && baudRate <= 6){
+		uint8_t saveBR[] = {ESC, BRACKET, baudRate + '0', BR_SAVE_CMD};
+		SendBytes(saveBR, sizeof(saveBR));
+		Settle(LCDS_PACE_EEPROM, LCDS_SETTLE_EEPROM_US);
+		bResult = LCDS_ERR_SUCCESS;
+	}
+	else {
+		bResult = LCDS_ERR_ARG_BR_RANGE;
+	}
+	return bResult;
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t  LCDS::NegotiateSpeed(uint32_t dwSpeed, uint32_t dwSpeedCur)
+**
+**	Parameters:
+**		dwSpeed - the speed wanted: on UART a baud rate of SaveBR, up to 76800,
+**				on I2C the TWI clock, e.g. LCDS_I2C_HZ_FAST, on SPI the SPI clock
+**		dwSpeedCur - on UART the baud rate the display uses now, LCDS_SPD_DEFAULT
+**				for the speed of Begin; not used on I2C and SPI
+**
+**	Return Value:
+**		uint8_t
+**					- LCDS_ERR_SUCCESS - The action completed successfully
+**					- LCDS_ERR_ARG_BR_RANGE - A baud rate is not one of SaveBR
+**					- LCDS_ERR_NOT_CHECKED - The change was sent on UART, the display
+**						can not tell whether it took it
+**					- LCDS_ERR_SPEED_FALLBACK - The display did not answer at the speed,
+**						or the SPI clock is above PAR_SPD_MAX, a slower speed is used
+**					- LCDS_ERR_NO_ANSWER - The display did not answer on I2C at any speed
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function moves the display and the port to a faster speed; GetSpeed
+**		returns the speed in use afterwards. The commands queued before are sent
+**		at the old speed first.
+**		On UART the baud rate is saved in the EEPROM with the communication mode
+**		using it, then the display is reset, which takes effect when the mode
+**		jumpers are set to 0,1,1 or 1,1,1. The change is sent once, at dwSpeedCur,
+**		and nothing is sent when the display already uses dwSpeed. The display
+**		never answers on UART, so the change can not be checked and a later boot
+**		has to Begin at the new rate. It writes the EEPROM of the display, so it
+**		is a one time step to configure the display, not one for every boot.
+**		A PAR_ACCESS_USER port is taken to be a UART, as LCDSEmu; its send
+**		function has to follow GetSpeed.
+**		On I2C the display is probed at the new clock, and at LCDS_I2C_HZ when it
+**		does not acknowledge.
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::NegotiateSpeed(uint32_t dwSpeed, uint32_t dwSpeedCur) {
+	uint8_t bResult = LCDS_ERR_SUCCESS;
+	WaitIdle();
+	if (m_accessType == PAR_ACCESS_UART1 || m_accessType == PAR_ACCESS_UART2 || m_accessType == PAR_ACCESS_USER) {
+		uint8_t idxTarget = LCDS_STATE_UNKNOWN;
+		uint8_t idxCur = LCDS_STATE_UNKNOWN;
+		if (dwSpeedCur == LCDS_SPD_DEFAULT) {
+			dwSpeedCur = m_dwSpeed;
+		}
+		for (uint8_t idxBaud = 0; idxBaud < LCDS_BAUD_COUNT; idxBaud++) {
+			if (rgdwBaudLcds[idxBaud] == dwSpeed) {
+				idxTarget = idxBaud;
+			}
+			if (rgdwBaudLcds[idxBaud] == dwSpeedCur) {
+				idxCur = idxBaud;
+			}
+		}
+		if (idxTarget == LCDS_STATE_UNKNOWN || idxCur == LCDS_STATE_UNKNOWN) {
+			return LCDS_ERR_ARG_BR_RANGE;
+		}
+		if (idxCur != idxTarget) {
+			PortSpeedSet(dwSpeedCur);
+			SendBaudChange(idxTarget);
+			bResult = LCDS_ERR_NOT_CHECKED;
+		}
+		PortSpeedSet(dwSpeed);
+	}
+	else if (m_accessType == PAR_ACCESS_I2C) {
+		PortSpeedSet(dwSpeed);
+		if (!I2CProbe()) {
+			bResult = LCDS_ERR_NO_ANSWER;
+			if (dwSpeed != LCDS_I2C_HZ) {
+				PortSpeedSet(LCDS_I2C_HZ);
+				if (I2CProbe()) {
+					bResult = LCDS_ERR_SPEED_FALLBACK;
+				}
+			}
+		}
+	}
+	else {
+		if (pdspi != NULL && dwSpeed > PAR_SPD_MAX) {
+			dwSpeed = PAR_SPD_MAX;
+			bResult = LCDS_ERR_SPEED_FALLBACK;
+		}
+		PortSpeedSet(dwSpeed);
+	}
+	return bResult;
+}
+/* ------------------------------------------------------------------- */
+/** uint32_t  LCDS::GetSpeed()
+**
+**	Description:
+**		Returns the speed of the port: the baud rate on UART, the clock on I2C
+**		and SPI, LCDS_SPD_DEFAULT when it is not known
+**
+-----------------------------------------------------------------------*/
+uint32_t LCDS::GetSpeed() {
+	return m_dwSpeed;
+}
+/* ------------------------------------------------------------------- */
+/** void  LCDS::SendBaudChange(uint8_t idxBaud)
+**
+**	Parameters:
+**		idxBaud - the baud rate value of SaveBR
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function saves the baud rate and the UART communication mode using
+**		it, then resets the display and waits until it is done
+**
+-----------------------------------------------------------------------*/
+void LCDS::SendBaudChange(uint8_t idxBaud) {
+	EepromWrEn();
+	SaveBR(idxBaud);
+	EepromWrEn();
+	SaveCommToEeprom(LCDS_COMM_UART_EEPROM);
+	Reset();
+	WaitIdle();
+}
+/* ------------------------------------------------------------------- */
+/** void  LCDS::WaitIdle()
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function sends the pending batch and the queue, and waits until the
+**		UART transmitter is empty and the device is done with the slow commands,
+**		so that nothing is left for the port once its speed changes
+**
+-----------------------------------------------------------------------*/
+void LCDS::WaitIdle() {
+	SendBatch(true);
+	while ((m_fAsync && (GetQueueDepth() > 0 || m_imrkHead != m_imrkTail)) || IsBusy()) {
+		if (m_fAsync) {
+			Poll();
+		}
+	}
+#if !defined(LCDS_NO_UART)
+	if (m_accessType == PAR_ACCESS_UART1) {
+		Serial.flush();
+	}
+	else if (m_accessType == PAR_ACCESS_UART2) {
+		Serial1.flush();
+	}
+#endif
+}
+/* ------------------------------------------------------------------- */
+/** void  LCDS::PortSpeedSet(uint32_t dwSpeed)
+**
+**	Parameters:
+**		dwSpeed - the baud rate or the clock of the port
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function changes the speed of the port on the host side only
+**
+-----------------------------------------------------------------------*/
+void LCDS::PortSpeedSet(uint32_t dwSpeed) {
+	m_dwSpeed = dwSpeed;
+#if !defined(LCDS_NO_UART)
+	if (m_accessType == PAR_ACCESS_UART1) {
+		Serial.begin(dwSpeed);
+	}
+	else if (m_accessType == PAR_ACCESS_UART2) {
+		Serial1.begin(dwSpeed);
+	}
+#endif
+#if !defined(LCDS_NO_I2C)
+	if (m_accessType == PAR_ACCESS_I2C) {
+		Wire.setClock(dwSpeed);
+	}
+#endif
+	if (pdspi != NULL) {
+		pdspi->setSpeed(dwSpeed);
+	}
+}
+/* ------------------------------------------------------------------- */
+/** boolean  LCDS::I2CProbe()
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		boolean - true when the display acknowledges its TWI address
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function sends an empty transmission to the display, which it does
+**		not see as a command
+**
+-----------------------------------------------------------------------*/
+boolean LCDS::I2CProbe() {
+#if !defined(LCDS_NO_I2C)
+	Wire.beginTransmission(m_bI2CAddr);
+	return Wire.endTransmission() == 0;
+#else
+	return false;
+#endif
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t  LCDS::CharsToLcd(uint8_t charTable)
+**
+**	Parameters:
+**		charTable - the characters table index to program into LCD - in EEPROM or RAM
+**		
+**
+**	Return Value:
+**		uint8_t 
+**					- LCDS_ERR_SUCCESS - The action completed successfully 
+**					- LCDS_ERR_ARG_TABLE_RANGE - The argument is not within 0, 3 range
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function programs a table from EEPROM or RAM into LCD
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::CharsToLcd(uint8_t charTable){
+	LCDS_STAT_CMD(LCDS_STAT_CHAR_TABLE);
+	Pace(LCDS_PACE_CGRAM);
+	uint8_t bResult;
+	if (charTable >= 0 && charTable <= 3){
+		uint8_t progrTable[] = {ESC, BRACKET, charTable + '0', PRG_CHAR_CMD};
+		if (charTable != m_idxCharTable) {
+			m_idxCharTable = charTable;
+			SendBytes(progrTable, sizeof(progrTable));
+			Settle(LCDS_PACE_CGRAM, LCDS_SETTLE_TABLE_US);
+		}
+		bResult = LCDS_ERR_SUCCESS;
+	}
+	else {
+		bResult = LCDS_ERR_ARG_TABLE_RANGE;
+	}
+	return bResult;
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t  LCDS::SaveRamtoEeprom(uint8_t charTable)
+**
+**	Parameters:
+**		charTable - the characters table index to save in EEPROM from RAM
+**		
+**
+**	Return Value:
+**		uint8_t 
+**					- LCDS_ERR_SUCCESS - The action completed successfully 
+**					- LCDS_ERR_ARG_TABLE_RANGE - The argument is not within 0, 3 range
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function saves a table in EEPROM from RAM
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::SaveRamtoEeprom(uint8_t charTable){
+	LCDS_STAT_CMD(LCDS_STAT_EEPROM);
+	Pace(LCDS_PACE_CGRAM | LCDS_PACE_EEPROM);
+	uint8_t bResult;
+	if (charTable >= 0 && charTable <= 3){
+		uint8_t progrTable[] = {ESC, BRACKET, charTable + '0', SAVE_RAM_TO_EEPROM_CMD};
+		//the table may now differ from what the LCD was programmed with
+		m_idxCharTable = LCDS_STATE_UNKNOWN;
+		SendBytes(progrTable, sizeof(progrTable));
+		Settle(LCDS_PACE_CGRAM | LCDS_PACE_EEPROM, LCDS_SETTLE_SAVE_TABLE_US);
+		bResult = LCDS_ERR_SUCCESS;
+	}
+	else {
+		bResult = LCDS_ERR_ARG_TABLE_RANGE;
+	}
+	return bResult;
+}
+
+/* ------------------------------------------------------------------- */
+/** uint8_t  LCDS::LdEepromToRam(uint8_t charTable)
+**
+**	Parameters:
+**		charTable - the characters table index to save in RAM from EEPROM  
+**		
+**
+**	Return Value:
+**		uint8_t 
+**					- LCDS_ERR_SUCCESS - The action completed successfully 
+**					- LCDS_ERR_ARG_TABLE_RANGE - The argument is not within 0, 3 range
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function loads a table in RAM from EEPROM  
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::LdEepromToRam(uint8_t charTable){
+	LCDS_STAT_CMD(LCDS_STAT_EEPROM);
+	Pace(LCDS_PACE_CGRAM | LCDS_PACE_EEPROM);
+	uint8_t bResult;
+	if (charTable >= 0 && charTable <= 3){
+		uint8_t ldTable[] = {ESC, BRACKET, charTable + '0', LD_EEPROM_TO_RAM_CMD};
+		//the table may now differ from what the LCD was programmed with
+		m_idxCharTable = LCDS_STATE_UNKNOWN;
+		SendBytes(ldTable, sizeof(ldTable));
+		Settle(LCDS_PACE_CGRAM, LCDS_SETTLE_TABLE_US);
+		bResult = LCDS_ERR_SUCCESS;
+	}
+	else {
+		bResult = LCDS_ERR_ARG_TABLE_RANGE;
+	}
+	return bResult;
+}
+
+/* ------------------------------------------------------------------- */
+/** uint8_t  LCDS::SaveCommToEeprom(uint8_t commSel)
+**
+**	Parameters:
+**		commSel - communication mode selection parameter 
+**		
+**
+**	Return Value:
+**		uint8_t 
+**					- LCDS_ERR_SUCCESS - The action completed successfully 
+**					- LCDS_ERR_ARG_COMM_RANGE - The argument is not within 0, 7 range
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function saves the communication mode to EEPROM  
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::SaveCommToEeprom(uint8_t commSel){
+	LCDS_STAT_CMD(LCDS_STAT_EEPROM);
+	Pace(LCDS_PACE_EEPROM);
+	uint8_t bResult;
+/*	MD2, MD1, MD0 		Protocol 			Details
+	0,0,0 				UART 				2400 baud
+	0,0,1 				UART 				4800 baud
+	0,1,0 				UART 				9600 baud
+	0,1,1 				UART 				baud rate in EEPROM
+	1,0,0 				TWI 				address: 0x48
+	1,0,1 				TWI 				address in EEPROM
+	1,1,0 				SPI
+	1,1,1 				specified in EEPROM specified in EEPROM
+*/
+	if (commSel >= 0 && commSel <= 7){
+		uint8_t commMode[] = {ESC, BRACKET, commSel + '0', COMM_MODE_SAVE_CMD};
+		SendBytes(commMode, sizeof(commMode));
+		Settle(LCDS_PACE_EEPROM, LCDS_SETTLE_EEPROM_US);
+		bResult = LCDS_ERR_SUCCESS;
+	}
+	else {
+		bResult = LCDS_ERR_ARG_COMM_RANGE;
+	}
+	return bResult;
+}
+
+/* ------------------------------------------------------------------- */
+/** void  LCDS::EepromWrEn()
+**
+**	Parameters:
+**		none 
+**		
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function enables the write operation to EEPROM
+**
+-----------------------------------------------------------------------*/
+void LCDS::EepromWrEn(){
+	LCDS_STAT_CMD(LCDS_STAT_EEPROM);
+	Pace(LCDS_PACE_EEPROM);
+	uint8_t wrEn[] = {ESC, BRACKET,'0', EEPROM_WR_EN_CMD};
+	SendBytes(wrEn, sizeof(wrEn));
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t  LCDS::SaveCursorToEeprom(byte modeCrs)
+**
+**	Parameters:
+**		modeCrs - parameter for selecting the mode of the cursor 
+**		
+**
+**	Return Value:
+**		uint8_t 
+**					- LCDS_ERR_SUCCESS - The action completed successfully 
+**					- LCDS_ERR_ARG_CRS_RANGE - The argument is not within 0, 2 range
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function saves the cursor mode into EEPROM memory
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::SaveCursorToEeprom(uint8_t modeCrs){
+	LCDS_STAT_CMD(LCDS_STAT_EEPROM);
+	Pace(LCDS_PACE_EEPROM);
+	uint8_t bResult;
+	if (modeCrs >= 0 && modeCrs <= 2){
+		uint8_t crsSave[] = {ESC, BRACKET,modeCrs + '0', CURSOR_MODE_SAVE_CMD};
+		SendBytes(crsSave, sizeof(crsSave));
+		Settle(LCDS_PACE_EEPROM, LCDS_SETTLE_EEPROM_US);
+		bResult = LCDS_ERR_SUCCESS;
+	}
+	else {
+		bResult = LCDS_ERR_ARG_CRS_RANGE;
+	}
+	return bResult;
+}
+
+/* ------------------------------------------------------------------- */
+/** uint8_t  LCDS::SaveDisplayToEeprom(uint8_t modeDisp)
+**
+**	Parameters:
+**		modeDisp - parameter for selecting the display mode 
+**		
+**
+**	Return Value:
+**		uint8_t 
+**					- LCDS_ERR_SUCCESS - The action completed successfully 
+**					- LCDS_ERR_ARG_DSP_RANGE - The argument is not within 0, 3 range
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function saves the display mode into EEPROM memory
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::SaveDisplayToEeprom(uint8_t modeDisp){
+	LCDS_STAT_CMD(LCDS_STAT_EEPROM);
+	Pace(LCDS_PACE_EEPROM);
+	uint8_t bResult;
+	if (modeDisp >= 0 && modeDisp <= 3){
+		uint8_t dispSave[] = {ESC, BRACKET, modeDisp + '0', DISP_MODE_SAVE_CMD};
+		SendBytes(dispSave, sizeof(dispSave));
+		Settle(LCDS_PACE_EEPROM, LCDS_SETTLE_EEPROM_US);
 		bResult = LCDS_ERR_SUCCESS;
 	}
-	else {
-		bResult = LCDS_ERR_ARG_BR_RANGE;
+	else {
+		bResult = LCDS_ERR_ARG_DSP_RANGE;
+	}
+	return bResult;
+}
+/* ------------------------------------------------------------------- */
+/** unint8_t  LCDS::SetPos(uint8_t idxRow, uint8_t idxCol)
+**
+**	Parameters:
+**		idxRow - the row where the cursor will be positioned
+**		idxCol - the column at which the cursor will be positioned
+**		
+**
+**	Return Value:
+**		uint8_t 
+**					- LCDS_ERR_SUCCESS - The action completed successfully 
+**					- a combination of the following errors (OR-ed):
+**						- LCDS_ERR_ARG_COL_RANGE - The argument is not within 0, 39 range
+**						- LCDS_ERR_ARG_ROW_RANGE - The argument is not within 0, 2 range
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function sets the cursor position, where print writes. When the
+**		cursor is not shown, the position command is sent only when needed, e.g.
+**		not at all when the characters printed there did not change.
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::SetPos(uint8_t idxRow, uint8_t idxCol) {
+	LCDS_STAT_CMD(LCDS_STAT_SET_POS);
+	uint8_t bResult = LCDS_ERR_SUCCESS;
+	if (idxRow < 0 || idxRow > 2){
+		bResult |= LCDS_ERR_ARG_ROW_RANGE;
+	}
+	if (idxCol < 0 || idxCol > 39){
+		bResult |= LCDS_ERR_ARG_COL_RANGE;
+	}
+	if (bResult == LCDS_ERR_SUCCESS){
+		if (idxRow < LCDS_ROWS && !m_fCrsShown) {
+			//the cursor is not shown, it is moved by the next command that needs it
+			m_idxRowCrs = idxRow;
+			m_idxColCrs = idxCol;
+			m_fCrsKnown = true;
+		}
+		else {
+			SendPos(idxRow, idxCol);
+		}
+	}
+	return	bResult;
+}
+
+/* ------------------------------------------------------------------- */
+/** uint8_t  LCDS::DefineUserChar((uint8_t* strUserDef, uint8_t charPos)
+**
+**	Parameters:
+**		strUserDef - characters array containing the numerical value of each row in the char
+**		charPos - the position of the character saved in the memory 
+**		
+**
+**	Return Value:
+**		uint8_t 
+**					- LCDS_ERR_SUCCESS - The action completed successfully 
+**					- LCDS_ERR_ARG_POS_RANGE - The argument is not within 0, 7 range
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function saves a user defined char in the RAM memory
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::DefineUserChar(uint8_t* strUserDef, uint8_t charPos) {
+	return DefineUserChars(strUserDef, charPos, 1);
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t  LCDS::DefineUserChars(const uint8_t* rgbUserDefs, uint8_t charPosFirst, uint8_t charNumber)
+**
+**	Parameters:
+**		rgbUserDefs - the rows of the characters, 8 bytes for each character
+**		charPosFirst - the position in the memory of the first character
+**		charNumber - the number of characters to be defined
+**
+**	Return Value:
+**		uint8_t 
+**					- LCDS_ERR_SUCCESS - The action completed successfully 
+**					- LCDS_ERR_ARG_POS_RANGE - The characters do not fit within positions 0, 7
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function defines several consecutive user chars in one batch, followed by
+**		a single command that programs the RAM table into the LCD
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::DefineUserChars(const uint8_t* rgbUserDefs, uint8_t charPosFirst, uint8_t charNumber) {
+	LCDS_STAT_CMD(LCDS_STAT_DEF_CHAR);
+	uint8_t rgbCmd[LCDS_DEF_CHAR_CMD_LEN];
+	uint8_t progrTable[] = {ESC, BRACKET, '3', PRG_CHAR_CMD};
+	if (charNumber == 0 || charPosFirst > 7 || charNumber > 8 - charPosFirst) {
+		return LCDS_ERR_ARG_POS_RANGE;
+	}
+	Pace(LCDS_PACE_CGRAM);
+	BeginBatch();
+	for (uint8_t i = 0; i < charNumber; i++) {
+		//build the values to be sent for defining the custom character
+		rgbCmd[0] = ESC;
+		rgbCmd[1] = BRACKET;
+		EncodeUserDefChar(rgbUserDefs + 8 * i, rgbCmd + 2);
+		rgbCmd[LCDS_DEF_CHAR_CMD_LEN - 2] = charPosFirst + i + '0';
+		rgbCmd[LCDS_DEF_CHAR_CMD_LEN - 1] = DEF_CHAR_CMD;
+		SendBytes(rgbCmd, LCDS_DEF_CHAR_CMD_LEN);
+	}
+	//save the defined characters in the RAM, the RAM table changed so it is always sent
+	m_idxCharTable = 3;
+	SendBytes(progrTable, sizeof(progrTable));
+	Flush();
+	Settle(LCDS_PACE_CGRAM, charNumber * (uint32_t)LCDS_SETTLE_DEF_CHAR_US);
+	return LCDS_ERR_SUCCESS;
+}
+/* ------------------------------------------------------------------- */
+/** void  LCDS::DispUserChar(uint8_t* charPos, uint8_t charNumber, uint8_t idxRow, uint8_t idxCol)
+**
+**	Parameters:
+**		charPos - array containing the positions of the characters saved in the RAM memory 
+**		charNumber - the number of custom chars to be displayed on the LCD
+**		idxRow - the row at which the first character should be displayed
+**		idxCol - the column starting from where the character should be displayed
+**
+**	Return Value:
+**		uint8_t 
+**					- LCDS_ERR_SUCCESS - The action completed successfully
+**					- a combination of the following errors (OR-ed): 
+**						- LCDS_ERR_ARG_COL_RANGE - The argument is not within 0, 39 range
+**						- LCDS_ERR_ARG_ROW_RANGE - The argument is not within 0, 2 range
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function displays a user defined char at the specified position on the LCD
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::DispUserChar(uint8_t* charPos, uint8_t charNumber, uint8_t idxRow, uint8_t idxCol) {
+	LCDS_STAT_CMD(LCDS_STAT_DISP_CHAR);
+	uint8_t bResult = LCDS_ERR_SUCCESS;
+	if (idxRow < 0 || idxRow > 2){
+		bResult |= LCDS_ERR_ARG_ROW_RANGE;
+	}
+	if (idxCol < 0 || idxCol > 39){
+		bResult |= LCDS_ERR_ARG_COL_RANGE;
+	}
+	if (bResult == LCDS_ERR_SUCCESS){
+		//send the position of the character or characters that have to be displayed at the wanted line/column
+		WriteCells(idxRow, idxCol, charPos, charNumber);
+	}
+	return bResult;
+}
+/* ------------------------------------------------------------------- */
+/** void  LCDS::BuildUserDefChar(uint8_t* strUserDef,  char* cmdStr)
+**
+**	Parameters:
+**		strUserDef - bytes array containing the values to be converted in values that are recognized by the firmware
+**		cmdStr	   - characters array containing the values converted 
+**		
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function builds the string to be converted in an interpretable array of chars for the LCD
+**
+-----------------------------------------------------------------------*/
+void LCDS::BuildUserDefChar(uint8_t* strUserDef, char* cmdStr) {
+	//the values are appended to the string
+	cmdStr += strlen(cmdStr);
+	EncodeUserDefChar(strUserDef, (uint8_t*)cmdStr);
+	cmdStr[LCDS_DEF_CHAR_HEX_LEN] = 0;
+}
+/* ------------------------------------------------------------------- */
+/** void  LCDS::EncodeUserDefChar(const uint8_t* strUserDef, uint8_t* pbDst)
+**
+**	Parameters:
+**		strUserDef - the 8 rows of the character
+**		pbDst - buffer receiving LCDS_DEF_CHAR_HEX_LEN characters
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function writes each row as 0xHH; using a table of the hex digits.
+**		No terminating 0 is written.
+**
+-----------------------------------------------------------------------*/
+void LCDS::EncodeUserDefChar(const uint8_t* strUserDef, uint8_t* pbDst) {
+	static const char rgchHex[] = "0123456789ABCDEF";
+	for(uint8_t i = 0; i < 8; i++){
+		*pbDst++ = '0';
+		*pbDst++ = 'x';
+		*pbDst++ = rgchHex[strUserDef[i] >> 4];
+		*pbDst++ = rgchHex[strUserDef[i] & 0x0F];
+		*pbDst++ = ';';
+	}
+}
+/* ------------------------------------------------------------------- */
+/** void  LCDS::ShadowEnable(boolean fEnable)
+**
+**	Parameters:
+**		fEnable - true to send only the characters that changed, false to send every character
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		The library keeps a copy of the display RAM. When it is enabled (the default),
+**		WriteStringAtPos and DispUserChar only send the characters that differ from
+**		what the display already shows. The copy is updated in both modes.
+**
+-----------------------------------------------------------------------*/
+void LCDS::ShadowEnable(boolean fEnable) {
+	m_fShadow = fEnable;
+}
+/* ------------------------------------------------------------------- */
+/** void  LCDS::ShadowInvalidate()
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function marks the whole content of the display and the cursor position
+**		as not known, so the next writes are sent in full. It has to be called when
+**		the display was changed without this library, e.g. after a power glitch.
+**
+-----------------------------------------------------------------------*/
+void LCDS::ShadowInvalidate() {
+	memset(m_rgbShadowKnown, 0, sizeof(m_rgbShadowKnown));
+	m_fCrsKnown = false;
+	m_fDevKnown = false;
+	m_fSavedKnown = false;
+}
+/* ------------------------------------------------------------------- */
+/** void  LCDS::ForceResync()
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		The library keeps a mirror of the display settings: display and backlight,
+**		cursor mode, wrap column and the character table programmed into the LCD,
+**		and drops the commands that would not change them. This function forgets
+**		the mirror and the shadow, so the next commands are all sent. It has to be
+**		called when the device may have lost its state, e.g. after a power glitch;
+**		Reset calls it.
+**
+-----------------------------------------------------------------------*/
+void LCDS::ForceResync() {
+	m_bDispEn = LCDS_STATE_UNKNOWN;
+	m_modeCrs = LCDS_STATE_UNKNOWN;
+	m_idxCharTable = LCDS_STATE_UNKNOWN;
+	m_colWrap = 0;
+	m_idxScroll = LCDS_STATE_UNKNOWN;
+	ShadowInvalidate();
+	m_cResync++;
+}
+/* ------------------------------------------------------------------- */
+/** uint16_t  LCDS::GetResyncCount()
+**
+**	Description:
+**		Returns the number of times the state of the device was forgotten: by
+**		Begin, Reset, ForceResync or a command dropped in asynchronous mode. A
+**		user of the state, e.g. LCDSGlyphCache, compares it with the value it
+**		last saw to know that the device may not hold what it defined.
+**
+-----------------------------------------------------------------------*/
+uint16_t LCDS::GetResyncCount() {
+	return m_cResync;
+}
+/* ------------------------------------------------------------------- */
+/** boolean  LCDS::IsCharOnScreen(uint8_t bChar)
+**
+**	Parameters:
+**		bChar - the character searched, e.g. the position of a user char
+**
+**	Return Value:
+**		boolean
+**					- true - a cell of the display RAM holds the character, or is not known
+**					- false - no cell of the display RAM holds the character
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function searches the shadow of the display RAM. All 40 columns are
+**		searched, as scrolling can bring any of them on the screen. It is used to
+**		avoid redefining a user char that is displayed.
+**
+-----------------------------------------------------------------------*/
+boolean LCDS::IsCharOnScreen(uint8_t bChar) {
+	for (uint8_t idxRow = 0; idxRow < LCDS_ROWS; idxRow++) {
+		for (uint8_t idxCol = 0; idxCol < LCDS_COLS; idxCol++) {
+			if (!IsShadowKnown(idxRow, idxCol) || m_rgbShadow[idxRow][idxCol] == bChar) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+/* ------------------------------------------------------------------- */
+/** void  LCDS::SendPos(uint8_t idxRow, uint8_t idxCol)
+**
+**	Parameters:
+**		idxRow - the row where the cursor will be positioned
+**		idxCol - the column at which the cursor will be positioned
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function moves the device cursor to a position, which also becomes the
+**		position expected by the caller. Nothing is sent when the device cursor is
+**		known to be there already. A short move forward on the same row is done by
+**		sending again the characters the shadow holds, when that is shorter than the
+**		position command. The arguments are not checked.
+**
+-----------------------------------------------------------------------*/
+void LCDS::SendPos(uint8_t idxRow, uint8_t idxCol) {
+	Pace(LCDS_PACE_DDRAM);
+	if (!m_fDevKnown || m_idxRowDev != idxRow || m_idxColDev != idxCol) {
+		if (!MoveByText(idxRow, idxCol)) {
+			//separate the position digits in order to send them, the leading zero is not needed
+			uint8_t stringToSend[LCDS_POS_CMD_LEN];
+			uint8_t cbSnd = 0;
+			stringToSend[cbSnd++] = ESC;
+			stringToSend[cbSnd++] = BRACKET;
+			stringToSend[cbSnd++] = idxRow + '0';
+			stringToSend[cbSnd++] = ';';
+			if (idxCol >= 10) {
+				stringToSend[cbSnd++] = idxCol / 10 + '0';
+			}
+			stringToSend[cbSnd++] = idxCol % 10 + '0';
+			stringToSend[cbSnd++] = CURSOR_POS_CMD;
+			SendBytes(stringToSend, cbSnd);
+		}
+	}
+	m_idxRowCrs = idxRow;
+	m_idxColCrs = idxCol;
+	m_fCrsKnown = (idxRow < LCDS_ROWS);
+	m_idxRowDev = idxRow;
+	m_idxColDev = idxCol;
+	m_fDevKnown = m_fCrsKnown;
+}
+/* ------------------------------------------------------------------- */
+/** boolean  LCDS::MoveByText(uint8_t idxRow, uint8_t idxCol)
+**
+**	Parameters:
+**		idxRow - the row where the cursor will be positioned
+**		idxCol - the column at which the cursor will be positioned
+**
+**	Return Value:
+**		boolean
+**					- true - the cursor was moved by sending the characters it passes over
+**					- false - nothing was sent, the position command is shorter or needed
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Writing a character moves the device cursor one column forward, so writing
+**		again the characters the display already holds moves the cursor without
+**		changing the display. This is done only when all of them are known, when
+**		the move stays before the wrap column and when it is shorter than the
+**		position command.
+**
+-----------------------------------------------------------------------*/
+boolean LCDS::MoveByText(uint8_t idxRow, uint8_t idxCol) {
+	if (!m_fShadow || !m_fDevKnown || m_idxRowDev != idxRow || m_idxColDev >= idxCol ||
+		idxCol - m_idxColDev >= PosCmdLen(idxCol) || idxCol >= ((m_colWrap != 0) ? m_colWrap : 16)) {
+		return false;
+	}
+	for (uint8_t idxColCur = m_idxColDev; idxColCur < idxCol; idxColCur++) {
+		if (!IsShadowKnown(idxRow, idxColCur)) {
+			return false;
+		}
+	}
+	SendBytes(&m_rgbShadow[idxRow][m_idxColDev], idxCol - m_idxColDev);
+	return true;
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t  LCDS::PosCmdLen(uint8_t idxCol)
+**
+**	Description:
+**		Returns the number of bytes of the position command for a column
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::PosCmdLen(uint8_t idxCol) {
+	return (idxCol >= 10) ? LCDS_POS_CMD_LEN : LCDS_POS_CMD_LEN - 1;
+}
+/* ------------------------------------------------------------------- */
+/** void  LCDS::SyncCursor()
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		WriteCells may skip the characters at the end of a string that did not
+**		change, leaving the device cursor before the position where the caller
+**		expects it. This function moves it there before a command that works at
+**		the cursor. When neither position is known they are the same.
+**
+-----------------------------------------------------------------------*/
+void LCDS::SyncCursor() {
+	if (m_fCrsKnown) {
+		SendPos(m_idxRowCrs, m_idxColCrs);
 	}
-	return bResult;
 }
 /* ------------------------------------------------------------------- */
-/** uint8_t  LCDS::CharsToLcd(uint8_t charTable)
+/** void  LCDS::AdvancePos(uint8_t* pidxRow, uint8_t* pidxCol)
 **
 **	Parameters:
-**		charTable - the characters table index to program into LCD - in EEPROM or RAM
-**		
+**		pidxRow - the row, updated
+**		pidxCol - the column, updated
 **
 **	Return Value:
-**		uint8_t 
-**					- LCDS_ERR_SUCCESS - The action completed successfully 
-**					- LCDS_ERR_ARG_TABLE_RANGE - The argument is not within 0, 3 range
+**		none
 **
 **	Errors:
 **		none
 **
 **	Description:
-**		This function programs a table from EEPROM or RAM into LCD
+**		This function moves a position one cell forward, going to the start of the
+**		other row at the wrap column set by DisplayMode or at the end of the row
 **
 -----------------------------------------------------------------------*/
-uint8_t LCDS::CharsToLcd(uint8_t charTable){
-	uint8_t bResult;
-	if (charTable >= 0 && charTable <= 3){
-		uint8_t progrTable[] = {ESC, BRACKET, charTable + '0', PRG_CHAR_CMD, 0};
-		if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)progrTable);
-		else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)progrTable);
-		else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(progrTable,4); Wire.endTransmission();}
-		else SPISendBytes(progrTable, 4);
-		bResult = LCDS_ERR_SUCCESS;
-	}
-	else {
-		bResult = LCDS_ERR_ARG_TABLE_RANGE;
+void LCDS::AdvancePos(uint8_t* pidxRow, uint8_t* pidxCol) {
+	(*pidxCol)++;
+	if (*pidxCol == m_colWrap || *pidxCol == LCDS_COLS) {
+		*pidxCol = 0;
+		*pidxRow = (*pidxRow + 1) % LCDS_ROWS;
 	}
-	return bResult;
 }
 /* ------------------------------------------------------------------- */
-/** uint8_t  LCDS::SaveRamtoEeprom(uint8_t charTable)
+/** void  LCDS::WriteCells(uint8_t idxRow, uint8_t idxCol, const uint8_t* rgbText, uint8_t cbText)
 **
 **	Parameters:
-**		charTable - the characters table index to save in EEPROM from RAM
-**		
+**		idxRow - the row of the first character
+**		idxCol - the column of the first character
+**		rgbText - the characters to be written
+**		cbText - the number of characters
 **
 **	Return Value:
-**		uint8_t 
-**					- LCDS_ERR_SUCCESS - The action completed successfully 
-**					- LCDS_ERR_ARG_TABLE_RANGE - The argument is not within 0, 3 range
+**		none
 **
 **	Errors:
 **		none
 **
 **	Description:
-**		This function saves a table in EEPROM from RAM
+**		This function writes characters in the display RAM starting at a position.
+**		The characters that the shadow shows as already displayed are skipped. A
+**		gap of unchanged characters between two changes is sent again when it is
+**		not longer than the position command that would be needed to skip it, so
+**		the changes are sent with the fewest bytes. The cursor is left after the
+**		last character, as if all the characters were sent; the device cursor is
+**		only moved there when a command needs it.
 **
 -----------------------------------------------------------------------*/
-uint8_t LCDS::SaveRamtoEeprom(uint8_t charTable){
-	uint8_t bResult;
-	if (charTable >= 0 && charTable <= 3){
-		uint8_t progrTable[] = {ESC, BRACKET, charTable + '0', SAVE_RAM_TO_EEPROM_CMD, 0};
-		if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)progrTable);
-		else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)progrTable);
-		else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(progrTable,4); Wire.endTransmission();}
-		else SPISendBytes(progrTable, 4);
-		bResult = LCDS_ERR_SUCCESS;
+void LCDS::WriteCells(uint8_t idxRow, uint8_t idxCol, const uint8_t* rgbText, uint8_t cbText) {
+	Pace(LCDS_PACE_DDRAM);
+	if (idxRow >= LCDS_ROWS || (m_colWrap == 0 && idxCol < 16 && idxCol + cbText > 16)) {
+		//the cells written are not known, send everything
+		BeginBatch();
+		SendPos(idxRow, idxCol);
+		SendBytes(rgbText, cbText);
+		Flush();
+		ShadowInvalidate();
+		return;
 	}
-	else {
-		bResult = LCDS_ERR_ARG_TABLE_RANGE;
+	uint8_t idxRowCur = idxRow;
+	uint8_t idxColCur = idxCol;
+	uint8_t idxRowRun = 0;
+	uint8_t idxColRun = 0;
+	uint8_t ibRun = 0;
+	uint8_t ibLastChg = 0;
+	boolean fRun = false;
+	boolean fSent = false;
+	//when the wrap column is not known, the cursor may go to the other row after column 15
+	boolean fEndUnknown = (m_colWrap == 0 && idxCol + cbText == 16);
+	//the position commands and the text go in the same transactions
+	BeginBatch();
+	for (uint8_t ib = 0; ib <= cbText; ib++) {
+		boolean fChg = false;
+		if (ib < cbText) {
+			fChg = !m_fShadow || !IsShadowKnown(idxRowCur, idxColCur) || m_rgbShadow[idxRowCur][idxColCur] != rgbText[ib];
+			//the last char is sent anyway, so the device cursor goes where the caller expects it
+			fChg = fChg || (fEndUnknown && ib == cbText - 1);
+		}
+		//close the run at the end, or when skipping the gap is cheaper than sending it
+		if (fRun && (ib == cbText || (fChg && ib - ibLastChg - 1 > PosCmdLen(idxColCur)))) {
+			SendPos(idxRowRun, idxColRun);
+			SendBytes(rgbText + ibRun, ibLastChg - ibRun + 1);
+			fRun = false;
+			fSent = true;
+		}
+		if (ib == cbText) {
+			break;
+		}
+		if (fChg) {
+			if (!fRun) {
+				fRun = true;
+				ibRun = ib;
+				idxRowRun = idxRowCur;
+				idxColRun = idxColCur;
+			}
+			ibLastChg = ib;
+		}
+		m_rgbShadow[idxRowCur][idxColCur] = rgbText[ib];
+		m_rgbShadowKnown[idxRowCur][idxColCur >> 3] |= 1 << (idxColCur & 7);
+		AdvancePos(&idxRowCur, &idxColCur);
 	}
-	return bResult;
+	//the device cursor is after the last character sent, the caller expects it after the string
+	if (fSent) {
+		m_idxRowDev = idxRowRun;
+		m_idxColDev = idxColRun;
+		for (uint8_t ib = ibRun; ib <= ibLastChg; ib++) {
+			AdvancePos(&m_idxRowDev, &m_idxColDev);
+		}
+	}
+	m_idxRowCrs = idxRowCur;
+	m_idxColCrs = idxColCur;
+	m_fCrsKnown = !fEndUnknown;
+	m_fDevKnown = m_fDevKnown && !fEndUnknown;
+	if (m_fCrsShown) {
+		SyncCursor();
+	}
+	Flush();
 }
-
 /* ------------------------------------------------------------------- */
-/** uint8_t  LCDS::LdEepromToRam(uint8_t charTable)
+/** uint8_t  LCDS::UpdateRow(uint8_t idxRow, const char* szRow)
 **
 **	Parameters:
-**		charTable - the characters table index to save in RAM from EEPROM  
-**		
+**		idxRow - the row to be updated: 0 or 1
+**		szRow - the text wanted on the row, the columns after its end are blank;
+**				NULL for a blank row
 **
 **	Return Value:
 **		uint8_t 
-**					- LCDS_ERR_SUCCESS - The action completed successfully 
-**					- LCDS_ERR_ARG_TABLE_RANGE - The argument is not within 0, 3 range
+**					- LCDS_ERR_SUCCESS - The action completed successfully
+**					- LCDS_ERR_ARG_ROW_RANGE - The argument is not within 0, 1 range
 **
 **	Errors:
 **		none
 **
 **	Description:
-**		This function loads a table in RAM from EEPROM  
+**		This function makes the 40 columns of a row show a text, choosing the
+**		commands with the fewest bytes. The erase commands that could clear the
+**		blank parts (EraseInLine before or after the text or for the whole row,
+**		EraseChars for the blanks inside it) are evaluated with dry runs and
+**		added one at a time while they lower the cost; the characters that still
+**		differ are then written as by WriteStringAtPos. The cursor is left after
+**		the last column written.
 **
 -----------------------------------------------------------------------*/
-uint8_t LCDS::LdEepromToRam(uint8_t charTable){
-	uint8_t bResult;
-	if (charTable >= 0 && charTable <= 3){
-		uint8_t ldTable[] = {ESC, BRACKET, charTable + '0', LD_EEPROM_TO_RAM_CMD, 0};
-		if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)ldTable);
-		else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)ldTable);
-		else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(ldTable,4); Wire.endTransmission();}
-		else SPISendBytes(ldTable, 4);
-		bResult = LCDS_ERR_SUCCESS;
+uint8_t LCDS::UpdateRow(uint8_t idxRow, const char* szRow) {
+	LCDS_STAT_CMD(LCDS_STAT_UPDATE);
+	uint8_t rgbRow[LCDS_COLS];
+	LCDS_ERASE rgers[LCDS_ERASE_MAX];
+	uint8_t cers;
+	uint32_t fsSel = 0;
+	if (idxRow >= LCDS_ROWS) {
+		return LCDS_ERR_ARG_ROW_RANGE;
 	}
-	else {
-		bResult = LCDS_ERR_ARG_TABLE_RANGE;
+	memset(rgbRow, ' ', LCDS_COLS);
+	for (uint8_t idxCol = 0; szRow != NULL && idxCol < LCDS_COLS && szRow[idxCol] != 0; idxCol++) {
+		rgbRow[idxCol] = szRow[idxCol];
 	}
-	return bResult;
+	cers = FindErases(idxRow, rgbRow, rgers);
+	uint16_t cbBest = RowCost(idxRow, rgbRow, rgers, cers, 0);
+	//add the erase that saves the most bytes, until none saves any
+	while (true) {
+		uint8_t iersBest = cers;
+		for (uint8_t iers = 0; iers < cers; iers++) {
+			if (!(fsSel & (1UL << iers))) {
+				uint16_t cb = RowCost(idxRow, rgbRow, rgers, cers, fsSel | (1UL << iers));
+				if (cb < cbBest) {
+					cbBest = cb;
+					iersBest = iers;
+				}
+			}
+		}
+		if (iersBest == cers) {
+			break;
+		}
+		fsSel |= 1UL << iersBest;
+	}
+	BeginBatch();
+	WriteRow(idxRow, rgbRow, rgers, cers, fsSel);
+	Flush();
+	return LCDS_ERR_SUCCESS;
 }
-
 /* ------------------------------------------------------------------- */
-/** uint8_t  LCDS::SaveCommToEeprom(uint8_t commSel)
+/** void  LCDS::UpdateDisplay(const char* szRow0, const char* szRow1)
 **
 **	Parameters:
-**		commSel - communication mode selection parameter 
-**		
+**		szRow0 - the text wanted on the first row, NULL for a blank row
+**		szRow1 - the text wanted on the second row, NULL for a blank row
 **
 **	Return Value:
-**		uint8_t 
-**					- LCDS_ERR_SUCCESS - The action completed successfully 
-**					- LCDS_ERR_ARG_COMM_RANGE - The argument is not within 0, 7 range
+**		none
 **
 **	Errors:
 **		none
 **
 **	Description:
-**		This function saves the communication mode to EEPROM  
+**		This function updates both rows as UpdateRow does, and also considers
+**		clearing the display first. The sequence with the fewest bytes is sent.
+**		A clear also scrolls the display back to the first column, so the cost of
+**		the clear includes scrolling back to the offset shown; when the offset is
+**		not known the display is not cleared, and the view never moves.
 **
 -----------------------------------------------------------------------*/
-uint8_t LCDS::SaveCommToEeprom(uint8_t commSel){
-	uint8_t bResult;
-/*	MD2, MD1, MD0 		Protocol 			Details
-	0,0,0 				UART 				2400 baud
-	0,0,1 				UART 				4800 baud
-	0,1,0 				UART 				9600 baud
-	0,1,1 				UART 				baud rate in EEPROM
-	1,0,0 				TWI 				address: 0x48
-	1,0,1 				TWI 				address in EEPROM
-	1,1,0 				SPI
-	1,1,1 				specified in EEPROM specified in EEPROM
-*/
-	if (commSel >= 0 && commSel <= 7){
-		uint8_t commMode[] = {ESC, BRACKET, commSel + '0', COMM_MODE_SAVE_CMD, 0};
-		if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)commMode);
-		else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)commMode);
-		else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(commMode,4); Wire.endTransmission();}
-		else SPISendBytes(commMode, 4);
-		bResult = LCDS_ERR_SUCCESS;
+void LCDS::UpdateDisplay(const char* szRow0, const char* szRow1) {
+	LCDS_STAT_CMD(LCDS_STAT_UPDATE);
+	LCDS_MODEL mdl;
+	uint16_t cbRows;
+	uint16_t cbClear = 0xFFFF;
+	uint8_t idxScroll = m_idxScroll;
+	//evaluate both sequences
+	SaveModel(&mdl);
+	m_cDryRun++;
+	uint32_t cbStart = m_cbDryRun;
+	UpdateRow(0, szRow0);
+	UpdateRow(1, szRow1);
+	cbRows = m_cbDryRun - cbStart;
+	RestoreModel(&mdl);
+	if (idxScroll != LCDS_STATE_UNKNOWN) {
+		cbStart = m_cbDryRun;
+		DisplayClear();
+		ScrollTo(idxScroll);
+		UpdateRow(0, szRow0);
+		UpdateRow(1, szRow1);
+		cbClear = m_cbDryRun - cbStart;
+		RestoreModel(&mdl);
 	}
-	else {
-		bResult = LCDS_ERR_ARG_COMM_RANGE;
+	m_cDryRun--;
+	BeginBatch();
+	if (cbClear < cbRows) {
+		DisplayClear();
+		ScrollTo(idxScroll);
 	}
-	return bResult;
+	UpdateRow(0, szRow0);
+	UpdateRow(1, szRow1);
+	Flush();
 }
-
 /* ------------------------------------------------------------------- */
-/** void  LCDS::EepromWrEn()
+/** void  LCDS::UpdateVisible(const char* szRow0, const char* szRow1)
 **
 **	Parameters:
-**		none 
-**		
+**		szRow0 - the text wanted on the visible columns of the first row, NULL for blanks
+**		szRow1 - the text wanted on the visible columns of the second row, NULL for blanks
 **
 **	Return Value:
 **		none
@@ -779,230 +2813,392 @@ uint8_t LCDS::SaveCommToEeprom(uint8_t commSel){
 **		none
 **
 **	Description:
-**		This function enables the write operation to EEPROM
+**		This function makes the 16 columns shown by the display hold a text. Unlike
+**		UpdateRow, the text is not tied to the display RAM columns: when the wanted
+**		text is the current one shifted, as for a ticker, scrolling the display and
+**		writing the columns it brings in is cheaper than writing the whole text.
+**		The current scroll offset and the ones under which the shadow already holds
+**		the most wanted characters are evaluated with dry runs, and the cheapest one
+**		is used. When the scroll offset is not known the display is cleared first.
 **
 -----------------------------------------------------------------------*/
-void LCDS::EepromWrEn(){
-	uint8_t wrEn[] = {ESC, BRACKET,'0', EEPROM_WR_EN_CMD, 0};
-	if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)wrEn);
-	else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)wrEn);
-	else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(wrEn,4); Wire.endTransmission();}
-	else SPISendBytes(wrEn, 4);
+void LCDS::UpdateVisible(const char* szRow0, const char* szRow1) {
+	LCDS_STAT_CMD(LCDS_STAT_UPDATE);
+	uint8_t rgbVis[LCDS_ROWS][LCDS_VISIBLE_COLS];
+	const char* rgszRow[LCDS_ROWS] = {szRow0, szRow1};
+	uint8_t rgidxTry[LCDS_SCROLL_TRIES];
+	uint8_t rgcMatchTry[LCDS_SCROLL_TRIES];
+	uint8_t cTry = 0;
+	for (uint8_t idxRow = 0; idxRow < LCDS_ROWS; idxRow++) {
+		memset(rgbVis[idxRow], ' ', LCDS_VISIBLE_COLS);
+		for (uint8_t idxCol = 0; rgszRow[idxRow] != NULL && idxCol < LCDS_VISIBLE_COLS && rgszRow[idxRow][idxCol] != 0; idxCol++) {
+			rgbVis[idxRow][idxCol] = rgszRow[idxRow][idxCol];
+		}
+	}
+	BeginBatch();
+	if (m_idxScroll == LCDS_STATE_UNKNOWN) {
+		DisplayClear();
+	}
+	//keep the offsets that hold more of the text than the current one, best first
+	uint8_t cMatchCur = VisibleMatches(m_idxScroll, rgbVis);
+	for (uint8_t idxScroll = 0; idxScroll < LCDS_COLS; idxScroll++) {
+		uint8_t cMatch = VisibleMatches(idxScroll, rgbVis);
+		uint8_t iTry;
+		if (idxScroll == m_idxScroll || cMatch <= cMatchCur) {
+			continue;
+		}
+		if (cTry < LCDS_SCROLL_TRIES) {
+			iTry = cTry++;
+		}
+		else if (cMatch > rgcMatchTry[LCDS_SCROLL_TRIES - 1]) {
+			iTry = LCDS_SCROLL_TRIES - 1;
+		}
+		else {
+			continue;
+		}
+		for (; iTry > 0 && rgcMatchTry[iTry - 1] < cMatch; iTry--) {
+			rgidxTry[iTry] = rgidxTry[iTry - 1];
+			rgcMatchTry[iTry] = rgcMatchTry[iTry - 1];
+		}
+		rgidxTry[iTry] = idxScroll;
+		rgcMatchTry[iTry] = cMatch;
+	}
+	uint8_t idxBest = m_idxScroll;
+	uint16_t cbBest = (cTry > 0) ? VisibleCost(m_idxScroll, rgbVis) : 0;
+	for (uint8_t iTry = 0; iTry < cTry; iTry++) {
+		uint16_t cb = VisibleCost(rgidxTry[iTry], rgbVis);
+		if (cb < cbBest) {
+			cbBest = cb;
+			idxBest = rgidxTry[iTry];
+		}
+	}
+	ScrollTo(idxBest);
+	WriteVisible(rgbVis);
+	Flush();
 }
 /* ------------------------------------------------------------------- */
-/** uint8_t  LCDS::SaveCursorToEeprom(byte modeCrs)
+/** uint8_t  LCDS::FindErases(uint8_t idxRow, const uint8_t* rgbRow, LCDS_ERASE* rgers)
 **
 **	Parameters:
-**		modeCrs - parameter for selecting the mode of the cursor 
-**		
+**		idxRow - the row to be updated
+**		rgbRow - the 40 characters wanted on the row
+**		rgers - receives the erase commands that could help, at most LCDS_ERASE_MAX
 **
 **	Return Value:
-**		uint8_t 
-**					- LCDS_ERR_SUCCESS - The action completed successfully 
-**					- LCDS_ERR_ARG_CRS_RANGE - The argument is not within 0, 2 range
+**		uint8_t - the number of erase commands found
 **
 **	Errors:
 **		none
 **
 **	Description:
-**		This function saves the cursor mode into EEPROM memory
+**		This function lists the erase commands that clear only columns that have
+**		to be blank and that are not all known to be blank already: the whole row,
+**		the columns before the first and after the last non blank character, and
+**		each group of blanks between them. They are listed in the order they are
+**		sent, by column.
 **
 -----------------------------------------------------------------------*/
-uint8_t LCDS::SaveCursorToEeprom(uint8_t modeCrs){
-	uint8_t bResult;
-	if (modeCrs >= 0 && modeCrs <= 2){
-		uint8_t crsSave[] = {ESC, BRACKET,modeCrs + '0', CURSOR_MODE_SAVE_CMD, 0};
-		if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)crsSave);
-		else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)crsSave);
-		else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(crsSave,4); Wire.endTransmission();}
-		else SPISendBytes(crsSave, 4);
-		bResult = LCDS_ERR_SUCCESS;
+uint8_t LCDS::FindErases(uint8_t idxRow, const uint8_t* rgbRow, LCDS_ERASE* rgers) {
+	uint8_t cers = 0;
+	int8_t idxFirst = -1;
+	int8_t idxLast = -1;
+	for (uint8_t idxCol = 0; idxCol < LCDS_COLS; idxCol++) {
+		if (rgbRow[idxCol] != ' ') {
+			if (idxFirst < 0) {
+				idxFirst = idxCol;
+			}
+			idxLast = idxCol;
+		}
 	}
-	else {
-		bResult = LCDS_ERR_ARG_CRS_RANGE;
+	if (!IsBlankKnown(idxRow, 0, LCDS_COLS - 1)) {
+		if (idxFirst < 0) {
+			//the row has to be blank, clear it from the column of the cursor
+			rgers[cers].bCmd = ERASE_INLINE_CMD;
+			rgers[cers].bParam = 2;
+			rgers[cers++].idxCol = (m_fDevKnown && m_idxRowDev == idxRow) ? m_idxColDev : 0;
+			return cers;
+		}
+		//the whole row can be cleared from any column, keep the cursor where it is if possible
+		rgers[cers].bCmd = ERASE_INLINE_CMD;
+		rgers[cers].bParam = 2;
+		rgers[cers++].idxCol = (m_fDevKnown && m_idxRowDev == idxRow) ? m_idxColDev : idxFirst;
 	}
-	return bResult;
+	if (idxFirst > 0 && !IsBlankKnown(idxRow, 0, idxFirst - 1)) {
+		rgers[cers].bCmd = ERASE_INLINE_CMD;
+		rgers[cers].bParam = 1;
+		rgers[cers++].idxCol = idxFirst - 1;
+	}
+	for (uint8_t idxCol = idxFirst + 1; idxFirst >= 0 && idxCol < idxLast && cers < LCDS_ERASE_MAX - 1; idxCol++) {
+		if (rgbRow[idxCol] == ' ' && rgbRow[idxCol - 1] != ' ') {
+			uint8_t idxEnd = idxCol;
+			while (rgbRow[idxEnd + 1] == ' ') {
+				idxEnd++;
+			}
+			if (!IsBlankKnown(idxRow, idxCol, idxEnd)) {
+				rgers[cers].bCmd = ERASE_FIELD_CMD;
+				rgers[cers].bParam = idxEnd - idxCol + 1;
+				rgers[cers++].idxCol = idxCol;
+			}
+		}
+	}
+	if (idxLast >= 0 && idxLast < LCDS_COLS - 1 && !IsBlankKnown(idxRow, idxLast + 1, LCDS_COLS - 1)) {
+		rgers[cers].bCmd = ERASE_INLINE_CMD;
+		rgers[cers].bParam = 0;
+		rgers[cers++].idxCol = idxLast + 1;
+	}
+	return cers;
 }
-
 /* ------------------------------------------------------------------- */
-/** uint8_t  LCDS::SaveDisplayToEeprom(uint8_t modeDisp)
+/** boolean  LCDS::IsBlankKnown(uint8_t idxRow, uint8_t idxColFirst, uint8_t idxColLast)
+**
+**	Description:
+**		Returns true when the shadow knows that all the columns in the range are blank
+**
+-----------------------------------------------------------------------*/
+boolean LCDS::IsBlankKnown(uint8_t idxRow, uint8_t idxColFirst, uint8_t idxColLast) {
+	for (uint8_t idxCol = idxColFirst; idxCol <= idxColLast; idxCol++) {
+		if (!IsShadowKnown(idxRow, idxCol) || m_rgbShadow[idxRow][idxCol] != ' ') {
+			return false;
+		}
+	}
+	return true;
+}
+/* ------------------------------------------------------------------- */
+/** uint16_t  LCDS::RowCost(uint8_t idxRow, const uint8_t* rgbRow, const LCDS_ERASE* rgers, uint8_t cers, uint32_t fsSel)
 **
 **	Parameters:
-**		modeDisp - parameter for selecting the display mode 
-**		
+**		idxRow - the row to be updated
+**		rgbRow - the 40 characters wanted on the row
+**		rgers - the erase commands that can be used
+**		cers - the number of erase commands
+**		fsSel - one bit for each erase command used
 **
 **	Return Value:
-**		uint8_t 
-**					- LCDS_ERR_SUCCESS - The action completed successfully 
-**					- LCDS_ERR_ARG_DSP_RANGE - The argument is not within 0, 3 range
+**		uint16_t - the number of bytes WriteRow would send
 **
 **	Errors:
 **		none
 **
 **	Description:
-**		This function saves the display mode into EEPROM memory
+**		This function runs WriteRow without sending anything and restores the
+**		model of the display afterwards
 **
 -----------------------------------------------------------------------*/
-uint8_t LCDS::SaveDisplayToEeprom(uint8_t modeDisp){
-	uint8_t bResult;
-	if (modeDisp >= 0 && modeDisp <= 3){
-		uint8_t dispSave[] = {ESC, BRACKET, modeDisp + '0', DISP_MODE_SAVE_CMD, 0};
-		if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)dispSave);
-		else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)dispSave);
-		else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(dispSave,4); Wire.endTransmission();}
-		else SPISendBytes(dispSave, 4);
-		bResult = LCDS_ERR_SUCCESS;
-	}
-	else {
-		bResult = LCDS_ERR_ARG_DSP_RANGE;
-	}
-	return bResult;
+uint16_t LCDS::RowCost(uint8_t idxRow, const uint8_t* rgbRow, const LCDS_ERASE* rgers, uint8_t cers, uint32_t fsSel) {
+	LCDS_MODEL mdl;
+	SaveModel(&mdl);
+	m_cDryRun++;
+	uint32_t cbStart = m_cbDryRun;
+	WriteRow(idxRow, rgbRow, rgers, cers, fsSel);
+	uint16_t cb = m_cbDryRun - cbStart;
+	m_cDryRun--;
+	RestoreModel(&mdl);
+	return cb;
 }
 /* ------------------------------------------------------------------- */
-/** unint8_t  LCDS::SetPos(uint8_t idxRow, uint8_t idxCol)
+/** void  LCDS::WriteRow(uint8_t idxRow, const uint8_t* rgbRow, const LCDS_ERASE* rgers, uint8_t cers, uint32_t fsSel)
 **
 **	Parameters:
-**		idxRow - the row where the cursor will be positioned
-**		idxCol - the column at which the cursor will be positioned
-**		
+**		idxRow - the row to be updated
+**		rgbRow - the 40 characters wanted on the row
+**		rgers - the erase commands that can be used
+**		cers - the number of erase commands
+**		fsSel - one bit for each erase command used
 **
 **	Return Value:
-**		uint8_t 
-**					- LCDS_ERR_SUCCESS - The action completed successfully 
-**					- a combination of the following errors (OR-ed):
-**						- LCDS_ERR_ARG_COL_RANGE - The argument is not within 0, 39 range
-**						- LCDS_ERR_ARG_ROW_RANGE - The argument is not within 0, 2 range
+**		none
 **
 **	Errors:
 **		none
 **
 **	Description:
-**		This function sets the cursor position
+**		This function sends the selected erase commands, then writes the characters
+**		that still differ. When the device does not wrap at 40 columns the row is
+**		written in two parts, so that no write goes past column 15.
 **
 -----------------------------------------------------------------------*/
-uint8_t LCDS::SetPos(uint8_t idxRow, uint8_t idxCol) {
-	uint8_t bResult = LCDS_ERR_SUCCESS;
-	if (idxRow < 0 || idxRow > 2){
-		bResult |= LCDS_ERR_ARG_ROW_RANGE;
+void LCDS::WriteRow(uint8_t idxRow, const uint8_t* rgbRow, const LCDS_ERASE* rgers, uint8_t cers, uint32_t fsSel) {
+	for (uint8_t iers = 0; iers < cers; iers++) {
+		if (fsSel & (1UL << iers)) {
+			SendPos(idxRow, rgers[iers].idxCol);
+			if (rgers[iers].bCmd == ERASE_INLINE_CMD) {
+				EraseInLine(rgers[iers].bParam);
+			}
+			else {
+				EraseChars(rgers[iers].bParam);
+			}
+		}
 	}
-	if (idxCol < 0 || idxCol > 39){
-		bResult |= LCDS_ERR_ARG_COL_RANGE;
+	if (m_colWrap == 40) {
+		WriteCells(idxRow, 0, rgbRow, LCDS_COLS);
 	}
-	if (bResult == LCDS_ERR_SUCCESS){
-		//separate the position digits in order to send them, useful when the position is greater than 10
-		uint8_t firstDigit 	= idxCol % 10;
-		uint8_t secondDigit 	= idxCol / 10;
-		uint8_t stringToSend[] = {ESC, BRACKET, idxRow + '0', ';', secondDigit + '0', firstDigit + '0', CURSOR_POS_CMD, 0};
-		if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)stringToSend);
-		else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)stringToSend);
-		else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(stringToSend,7); Wire.endTransmission();}
-		else SPISendBytes(stringToSend, 7);
+	else {
+		WriteCells(idxRow, 0, rgbRow, 16);
+		WriteCells(idxRow, 16, rgbRow + 16, LCDS_COLS - 16);
 	}
-	return	bResult;
+}
+/* ------------------------------------------------------------------- */
+/** void  LCDS::SaveModel(LCDS_MODEL* pmdl)
+**	void  LCDS::RestoreModel(const LCDS_MODEL* pmdl)
+**
+**	Description:
+**		Copy the shadow, the cursor positions and the settings mirror, so that a
+**		dry run can change them and they can be put back
+**
+-----------------------------------------------------------------------*/
+void LCDS::SaveModel(LCDS_MODEL* pmdl) {
+	memcpy(pmdl->rgbShadow, m_rgbShadow, sizeof(m_rgbShadow));
+	memcpy(pmdl->rgbShadowKnown, m_rgbShadowKnown, sizeof(m_rgbShadowKnown));
+	pmdl->idxRowCrs = m_idxRowCrs;
+	pmdl->idxColCrs = m_idxColCrs;
+	pmdl->fCrsKnown = m_fCrsKnown;
+	pmdl->idxRowDev = m_idxRowDev;
+	pmdl->idxColDev = m_idxColDev;
+	pmdl->fDevKnown = m_fDevKnown;
+	pmdl->idxRowSaved = m_idxRowSaved;
+	pmdl->idxColSaved = m_idxColSaved;
+	pmdl->fSavedKnown = m_fSavedKnown;
+	pmdl->bDispEn = m_bDispEn;
+	pmdl->modeCrs = m_modeCrs;
+	pmdl->idxCharTable = m_idxCharTable;
+	pmdl->colWrap = m_colWrap;
+	pmdl->idxScroll = m_idxScroll;
 }
 
+void LCDS::RestoreModel(const LCDS_MODEL* pmdl) {
+	memcpy(m_rgbShadow, pmdl->rgbShadow, sizeof(m_rgbShadow));
+	memcpy(m_rgbShadowKnown, pmdl->rgbShadowKnown, sizeof(m_rgbShadowKnown));
+	m_idxRowCrs = pmdl->idxRowCrs;
+	m_idxColCrs = pmdl->idxColCrs;
+	m_fCrsKnown = pmdl->fCrsKnown;
+	m_idxRowDev = pmdl->idxRowDev;
+	m_idxColDev = pmdl->idxColDev;
+	m_fDevKnown = pmdl->fDevKnown;
+	m_idxRowSaved = pmdl->idxRowSaved;
+	m_idxColSaved = pmdl->idxColSaved;
+	m_fSavedKnown = pmdl->fSavedKnown;
+	m_bDispEn = pmdl->bDispEn;
+	m_modeCrs = pmdl->modeCrs;
+	m_idxCharTable = pmdl->idxCharTable;
+	m_colWrap = pmdl->colWrap;
+	m_idxScroll = pmdl->idxScroll;
+}
 /* ------------------------------------------------------------------- */
-/** uint8_t  LCDS::DefineUserChar((uint8_t* strUserDef, uint8_t charPos)
+/** void  LCDS::ScrollTo(uint8_t idxScroll)
 **
 **	Parameters:
-**		strUserDef - characters array containing the numerical value of each row in the char
-**		charPos - the position of the character saved in the memory 
-**		
+**		idxScroll - the display RAM column to be shown first
 **
 **	Return Value:
-**		uint8_t 
-**					- LCDS_ERR_SUCCESS - The action completed successfully 
-**					- LCDS_ERR_ARG_POS_RANGE - The argument is not within 0, 7 range
+**		none
 **
 **	Errors:
 **		none
 **
 **	Description:
-**		This function saves a user defined char in the RAM memory
+**		This function scrolls the display in the direction that needs the fewest
+**		columns. The scroll offset has to be known.
 **
 -----------------------------------------------------------------------*/
-uint8_t LCDS::DefineUserChar(uint8_t* strUserDef, uint8_t charPos) {
-	char rgcCmd[MAX];
-	int bytes;
-	uint8_t bResult;
-	if (charPos >= 0 && charPos <= 7){
-		rgcCmd[0] = ESC;
-		rgcCmd[1] = BRACKET;
-		rgcCmd[2] = 0;
-		//build the values to be sent for defining the custom character
-		BuildUserDefChar(strUserDef, rgcCmd + 2);
-		byte bLength = strlen(rgcCmd);
-		rgcCmd[bLength++] = (char)charPos + '0';
-		rgcCmd[bLength++] = DEF_CHAR_CMD;
-		//save the defined character in the RAM
-		rgcCmd[bLength++] = ESC;
-		rgcCmd[bLength++] = BRACKET;
-		rgcCmd[bLength++] = '3';
-		rgcCmd[bLength++] = PRG_CHAR_CMD;
-		rgcCmd[bLength++] = 0;
-		if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)(rgcCmd));
-		else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)(rgcCmd));
-		//Since the I2C wire library only uses a 32byte buffer, we can only send 30 bytes at a time max.
-		else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write((unsigned char*)(rgcCmd),30); Wire.endTransmission();
-												Wire.beginTransmission(0x48); Wire.write((unsigned char*)(rgcCmd+30),bLength-31); Wire.endTransmission();}
-		else SPISendBytes((unsigned char*)(rgcCmd), bLength-1);
-		bResult = LCDS_ERR_SUCCESS;
+void LCDS::ScrollTo(uint8_t idxScroll) {
+	uint8_t cCol = (idxScroll + LCDS_COLS - m_idxScroll) % LCDS_COLS;
+	if (cCol == 0) {
+		return;
+	}
+	if (cCol <= LCDS_COLS / 2) {
+		DisplayScroll(false, cCol);
 	}
 	else {
-		bResult = LCDS_ERR_ARG_POS_RANGE;
+		DisplayScroll(true, LCDS_COLS - cCol);
 	}
-	return bResult;
 }
 /* ------------------------------------------------------------------- */
-/** void  LCDS::DispUserChar(uint8_t* charPos, uint8_t charNumber, uint8_t idxRow, uint8_t idxCol)
+/** void  LCDS::WriteVisible(const uint8_t rgbVis[LCDS_ROWS][LCDS_VISIBLE_COLS])
 **
 **	Parameters:
-**		charPos - array containing the positions of the characters saved in the RAM memory 
-**		charNumber - the number of custom chars to be displayed on the LCD
-**		idxRow - the row at which the first character should be displayed
-**		idxCol - the column starting from where the character should be displayed
+**		rgbVis - the characters wanted on the visible columns of both rows
 **
 **	Return Value:
-**		uint8_t 
-**					- LCDS_ERR_SUCCESS - The action completed successfully
-**					- a combination of the following errors (OR-ed): 
-**						- LCDS_ERR_ARG_COL_RANGE - The argument is not within 0, 39 range
-**						- LCDS_ERR_ARG_ROW_RANGE - The argument is not within 0, 2 range
+**		none
 **
 **	Errors:
 **		none
 **
 **	Description:
-**		This function displays a user defined char at the specified position on the LCD
+**		This function writes the characters that differ at the display RAM columns
+**		shown under the current scroll offset. The visible columns are written in
+**		parts that do not go past the last column, nor past column 15 when the
+**		device does not wrap at 40 columns.
 **
 -----------------------------------------------------------------------*/
-uint8_t LCDS::DispUserChar(uint8_t* charPos, uint8_t charNumber, uint8_t idxRow, uint8_t idxCol) {
-	uint8_t bResult = LCDS_ERR_SUCCESS;
-	if (idxRow < 0 || idxRow > 2){
-		bResult |= LCDS_ERR_ARG_ROW_RANGE;
-	}
-	if (idxCol < 0 || idxCol > 39){
-		bResult |= LCDS_ERR_ARG_COL_RANGE;
+void LCDS::WriteVisible(const uint8_t rgbVis[LCDS_ROWS][LCDS_VISIBLE_COLS]) {
+	for (uint8_t idxRow = 0; idxRow < LCDS_ROWS; idxRow++) {
+		uint8_t idxVisFirst = 0;
+		for (uint8_t idxVis = 1; idxVis <= LCDS_VISIBLE_COLS; idxVis++) {
+			uint8_t idxCol = (m_idxScroll + idxVis) % LCDS_COLS;
+			if (idxVis == LCDS_VISIBLE_COLS || idxCol == 0 || (idxCol == 16 && m_colWrap != 40)) {
+				WriteCells(idxRow, (m_idxScroll + idxVisFirst) % LCDS_COLS, rgbVis[idxRow] + idxVisFirst, idxVis - idxVisFirst);
+				idxVisFirst = idxVis;
+			}
+		}
 	}
-	if (bResult == LCDS_ERR_SUCCESS){
-		//set the position of the cursor to the wanted line/column for displaying custom chars
-		SetPos(idxRow, idxCol);
-		//send the position of the character or characters that have to be displayed, and their number
-		Serial.println((char*)charPos);
-		if (m_accessType == PAR_ACCESS_UART1)Serial.write((char*)charPos);
-		else if (m_accessType == PAR_ACCESS_UART2)Serial1.write((char*)charPos);
-		else if(m_accessType == PAR_ACCESS_I2C){Wire.beginTransmission(0x48); Wire.write(charPos,charNumber); Wire.endTransmission();}
-		else SPISendBytes(charPos, charNumber);
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t  LCDS::VisibleMatches(uint8_t idxScroll, const uint8_t rgbVis[LCDS_ROWS][LCDS_VISIBLE_COLS])
+**
+**	Description:
+**		Returns the number of visible cells the shadow knows to hold the wanted
+**		character when the display RAM column idxScroll is shown first
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDS::VisibleMatches(uint8_t idxScroll, const uint8_t rgbVis[LCDS_ROWS][LCDS_VISIBLE_COLS]) {
+	uint8_t cMatch = 0;
+	for (uint8_t idxRow = 0; idxRow < LCDS_ROWS; idxRow++) {
+		for (uint8_t idxVis = 0; idxVis < LCDS_VISIBLE_COLS; idxVis++) {
+			uint8_t idxCol = (idxScroll + idxVis) % LCDS_COLS;
+			if (IsShadowKnown(idxRow, idxCol) && m_rgbShadow[idxRow][idxCol] == rgbVis[idxRow][idxVis]) {
+				cMatch++;
+			}
+		}
 	}
-	return bResult;
+	return cMatch;
 }
 /* ------------------------------------------------------------------- */
-/** void  LCDS::BuildUserDefChar(uint8_t* strUserDef,  char* cmdStr)
+/** uint16_t  LCDS::VisibleCost(uint8_t idxScroll, const uint8_t rgbVis[LCDS_ROWS][LCDS_VISIBLE_COLS])
 **
 **	Parameters:
-**		strUserDef - bytes array containing the values to be converted in values that are recognized by the firmware
-**		cmdStr	   - characters array containing the values converted 
-**		
+**		idxScroll - the display RAM column to be shown first
+**		rgbVis - the characters wanted on the visible columns of both rows
+**
+**	Return Value:
+**		uint16_t - the number of bytes ScrollTo and WriteVisible would send
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function runs ScrollTo and WriteVisible without sending anything and
+**		restores the model of the display afterwards
+**
+-----------------------------------------------------------------------*/
+uint16_t LCDS::VisibleCost(uint8_t idxScroll, const uint8_t rgbVis[LCDS_ROWS][LCDS_VISIBLE_COLS]) {
+	LCDS_MODEL mdl;
+	SaveModel(&mdl);
+	m_cDryRun++;
+	uint32_t cbStart = m_cbDryRun;
+	ScrollTo(idxScroll);
+	WriteVisible(rgbVis);
+	uint16_t cb = m_cbDryRun - cbStart;
+	m_cDryRun--;
+	RestoreModel(&mdl);
+	return cb;
+}
+/* ------------------------------------------------------------------- */
+/** void  LCDS::ShadowErase(uint8_t idxColFirst, uint8_t idxColLast)
+**
+**	Parameters:
+**		idxColFirst - the first column erased on the cursor row
+**		idxColLast - the last column erased on the cursor row
 **
 **	Return Value:
 **		none
@@ -1011,19 +3207,17 @@ uint8_t LCDS::DispUserChar(uint8_t* charPos, uint8_t charNumber, uint8_t idxRow,
 **		none
 **
 **	Description:
-**		This function builds the string to be converted in an interpretable array of chars for the LCD
+**		This function updates the shadow after an erase command. When the row of the
+**		cursor is not known, the whole shadow is invalidated.
 **
 -----------------------------------------------------------------------*/
-void LCDS::BuildUserDefChar(uint8_t* strUserDef, char* cmdStr) {
-	uint8_t len = 8;
-	char elStr[4];
-	//print the bytes from the input array as hex values
-	for(int i = 0; i < len; i++){
-		sprintf(elStr, "%2.2X", strUserDef[i]);
-		//concatenate the result with the 0x chars to be able to send it to the LCD
-		strcat(cmdStr, "0x");
-		elStr[2] = 0;
-		strcat(cmdStr, elStr);
-		strcat(cmdStr, ";");
-	}
-}
\ No newline at end of file
+void LCDS::ShadowErase(uint8_t idxColFirst, uint8_t idxColLast) {
+	if (!m_fCrsKnown) {
+		ShadowInvalidate();
+		return;
+	}
+	for (uint8_t i = idxColFirst; i <= idxColLast; i++) {
+		m_rgbShadow[m_idxRowCrs][i] = ' ';
+		m_rgbShadowKnown[m_idxRowCrs][i >> 3] |= 1 << (i & 7);
+	}
+}
@@ -18,31 +18,7 @@
 /************************************************************************/
 #if !defined(LCDS_H)
 #define LCDS_H
-//commands for the display list
-#define ESC 					0x1B
-#define BRACKET					0x5B //[
-#define CURSOR_POS_CMD			0x48 //H
-#define CURSOR_SAVE_CMD			0x73 //s
-#define CURSOR_RSTR_CMD			0x75 //u
-#define DISP_CLR_CMD			0x6A //j
-#define ERASE_INLINE_CMD		0x4B //K
-#define ERASE_FIELD_CMD			0x4E //N
-#define LSCROLL_CMD				0x40 //@
-#define RSCROLL_CMD				0x41 //A
-#define RST_CMD					0x2A //*
-#define DISP_EN_CMD				0x65 //e
-#define DISP_MODE_CMD			0x68 //h
-#define CURSOR_MODE_CMD			0x63 //c
-#define TWI_SAVE_ADDR_CMD		0x61 //a
-#define BR_SAVE_CMD				0x62 //b
-#define PRG_CHAR_CMD			0x70 //p
-#define SAVE_RAM_TO_EEPROM_CMD	0x74 //t
-#define LD_EEPROM_TO_RAM_CMD	0x6C //l
-#define DEF_CHAR_CMD			0x64 //d
-#define COMM_MODE_SAVE_CMD		0x6D //m
-#define EEPROM_WR_EN_CMD		0x77 //w
-#define CURSOR_MODE_SAVE_CMD	0x6E //n
-#define DISP_MODE_SAVE_CMD		0x6F //o
+#include "LCDSCmds.h"
 
 //access parameters for communication ports
 #define	PAR_ACCESS_DSPI0			0
@@ -50,7 +26,20 @@
 #define PAR_ACCESS_UART1			2
 #define PAR_ACCESS_UART2			3
 #define	PAR_ACCESS_I2C				4
+#define	PAR_ACCESS_USER				5
 #define	PAR_SPD_MAX				625000
+//default TWI address of the PmodCLS
+#define LCDS_I2C_ADDR			0x48
+//selects the default TWI address or chip select pin of the port in Begin
+#define LCDS_DEV_DEFAULT		0xFF
+//selects the default speed of the port in Begin
+#define LCDS_SPD_DEFAULT		0
+//speeds the PmodCLS starts with: UART baud rate selected by the jumpers, TWI clock
+#define LCDS_UART_BAUD			9600
+#define LCDS_I2C_HZ				100000
+#define LCDS_I2C_HZ_FAST		400000
+//communication mode of SaveCommToEeprom for UART at the baud rate saved by SaveBR
+#define LCDS_COMM_UART_EEPROM	3
 /* ------------------------------------------------------------ */
 /*					Errors Definitions							*/
 /* ------------------------------------------------------------ */
@@ -65,9 +54,91 @@
 #define LCDS_ERR_ARG_CRS_RANGE		7	// The argument is not within 0, 2 range for cursor modes
 #define LCDS_ERR_ARG_DSP_RANGE		8	// The argument is not within 0, 3 range for display settings types
 #define LCDS_ERR_ARG_POS_RANGE		9	// The argument is not within 0, 7 range for characters position in the memory
+#define LCDS_ERR_GROUP_FULL			10	// The display group can not hold more displays
+#define LCDS_ERR_SPEED_FALLBACK		11	// The display did not answer at the speed asked, a slower one is used
+#define LCDS_ERR_NO_ANSWER			12	// The display did not answer at any speed
+#define LCDS_ERR_NOT_CHECKED		13	// The command was sent but the display can not confirm it
 
 //other defines used for library functions
 #define MAX						150
+//size of the display RAM
+#define LCDS_ROWS				2
+#define LCDS_COLS				40
+//number of columns shown by the display
+#define LCDS_VISIBLE_COLS		16
+//most decimals written by WriteNumberAtPos
+#define LCDS_DECIMALS_MAX		9
+//number of bytes of the cursor position command
+#define LCDS_POS_CMD_LEN		7
+//number of bytes of the rows of a user char, written as 0xHH; and of the define char command
+#define LCDS_DEF_CHAR_HEX_LEN	40
+#define LCDS_DEF_CHAR_CMD_LEN	(LCDS_DEF_CHAR_HEX_LEN + 4)
+//size of the buffer used to batch commands
+#define LCDS_BATCH_MAX			64
+//size of the transmit buffer of the Wire library
+#define LCDS_I2C_BUF_LEN		32
+//size of the asynchronous transmit queue, a power of 2
+#define LCDS_TXQ_SIZE			256
+//default number of bytes sent by each Poll
+#define LCDS_TXQ_CHUNK			16
+//number of slow commands the transmit queue can hold, a power of 2
+#define LCDS_TXQ_MARKS			8
+//what to do when the transmit queue is full
+#define LCDS_TXQ_BLOCK			0
+#define LCDS_TXQ_DROP			1
+//value of a device setting that is not known
+#define LCDS_STATE_UNKNOWN		0xFF
+//number of erase commands UpdateRow can choose from
+#define LCDS_ERASE_MAX			16
+//number of scroll offsets UpdateVisible evaluates besides the current one
+#define LCDS_SCROLL_TRIES		3
+//classes of commands, a slow command makes the following commands of some classes wait
+#define LCDS_PACE_DDRAM			0x01	//text, cursor and display settings
+#define LCDS_PACE_CGRAM			0x02	//user chars and character tables
+#define LCDS_PACE_EEPROM		0x04	//settings saved in the EEPROM
+#define LCDS_PACE_ALL			0x07
+//time the device needs to process the slow commands, in us, 0 for none
+#if !defined(LCDS_SETTLE_CLEAR_US)
+#define LCDS_SETTLE_CLEAR_US	0
+#endif
+#if !defined(LCDS_SETTLE_DEF_CHAR_US)
+#define LCDS_SETTLE_DEF_CHAR_US	1250	//for each user char defined
+#endif
+#if !defined(LCDS_SETTLE_TABLE_US)
+#define LCDS_SETTLE_TABLE_US	2000	//character table programmed into the LCD or loaded from EEPROM
+#endif
+#if !defined(LCDS_SETTLE_EEPROM_US)
+#define LCDS_SETTLE_EEPROM_US	10000	//one setting saved in the EEPROM
+#endif
+#if !defined(LCDS_SETTLE_SAVE_TABLE_US)
+#define LCDS_SETTLE_SAVE_TABLE_US	40000	//character table saved in the EEPROM
+#endif
+#if !defined(LCDS_SETTLE_RESET_US)
+#define LCDS_SETTLE_RESET_US	20000
+#endif
+//commands counted by the statistics, LCDS_STAT_OTHER holds the bytes sent
+//outside of a command, e.g. by the Flush of a batch started by the application
+#define LCDS_STAT_OTHER			0
+#define LCDS_STAT_DISPLAY_SET	1
+#define LCDS_STAT_CURSOR_MODE	2
+#define LCDS_STAT_CLEAR			3
+#define LCDS_STAT_WRITE			4
+#define LCDS_STAT_SCROLL		5
+#define LCDS_STAT_CURSOR_SAVE	6
+#define LCDS_STAT_DISPLAY_MODE	7
+#define LCDS_STAT_ERASE			8
+#define LCDS_STAT_RESET			9
+#define LCDS_STAT_EEPROM		10
+#define LCDS_STAT_CHAR_TABLE	11
+#define LCDS_STAT_DEF_CHAR		12
+#define LCDS_STAT_DISP_CHAR		13
+#define LCDS_STAT_SET_POS		14
+#define LCDS_STAT_UPDATE		15
+#define LCDS_STAT_CMDS			16
+//communication ports counted by the statistics, indexed by PAR_ACCESS_xxx
+#define LCDS_STAT_PORTS			6
+//bins of the latency histogram, bin n counts the sends that took from 2^(n-1) to 2^n - 1 us
+#define LCDS_STAT_BINS			16
 
 /* ------------------------------------------------------------ */
 /*				Include File Definitions						*/
@@ -75,16 +146,76 @@
 #include <DSPI.h>
 #include <inttypes.h>
 #include <Wire.h>
+#include <Print.h>
+
+/* ------------------------------------------------------------ */
+/*					Type Declarations							*/
+/* ------------------------------------------------------------ */
+
+//send function used with PAR_ACCESS_USER, called once per transaction
+typedef void (*PFNLCDSSEND)(void* pvCtx, const uint8_t* rgbSnd, uint8_t cbSnd);
+
+//bus statistics, collected when LCDS_STATS_ENABLE is defined for the whole build,
+//see the members at the end of class LCDS
+typedef struct {
+	//per command: calls, bytes produced and transactions produced, queued or sent
+	uint32_t rgcCall[LCDS_STAT_CMDS];
+	uint32_t rgcbCmd[LCDS_STAT_CMDS];
+	uint32_t rgcTransCmd[LCDS_STAT_CMDS];
+	//per port: bytes and transactions put on the bus
+	uint32_t rgcbPort[LCDS_STAT_PORTS];
+	uint32_t rgcTransPort[LCDS_STAT_PORTS];
+	//per port: histogram and maximum of the time spent sending one transaction, in us
+	uint32_t rgcLatency[LCDS_STAT_PORTS][LCDS_STAT_BINS];
+	uint32_t rgusLatencyMax[LCDS_STAT_PORTS];
+} LCDS_STATS;
+
+//end of a slow command in the transmit queue, Poll starts its settle time once it is sent
+typedef struct {
+	uint16_t ibEnd;
+	uint8_t fsPace;
+	uint32_t usSettle;
+} LCDS_TXQ_MARK;
+
+//an erase command considered by UpdateRow
+typedef struct {
+	uint8_t bCmd;		//ERASE_INLINE_CMD or ERASE_FIELD_CMD
+	uint8_t bParam;		//erase mode or number of chars
+	uint8_t idxCol;		//column where the cursor is put
+} LCDS_ERASE;
+
+//copy of what the library knows about the display, used by the dry runs
+typedef struct {
+	uint8_t rgbShadow[LCDS_ROWS][LCDS_COLS];
+	uint8_t rgbShadowKnown[LCDS_ROWS][(LCDS_COLS + 7) / 8];
+	uint8_t idxRowCrs;
+	uint8_t idxColCrs;
+	boolean fCrsKnown;
+	uint8_t idxRowDev;
+	uint8_t idxColDev;
+	boolean fDevKnown;
+	uint8_t idxRowSaved;
+	uint8_t idxColSaved;
+	boolean fSavedKnown;
+	uint8_t bDispEn;
+	uint8_t modeCrs;
+	uint8_t idxCharTable;
+	uint8_t colWrap;
+	uint8_t idxScroll;
+} LCDS_MODEL;
 
 /* ------------------------------------------------------------ */
 /*					Procedure Declarations						*/
 /* ------------------------------------------------------------ */
 
-class LCDS {
+class LCDS : public Print {
 public:
 	LCDS();
-	//initializes the driver and configures the communication interface 
-	void Begin(uint8_t accessType);
+	//initializes the driver and configures the communication interface, bDevSel is the
+	//TWI address of the display or the pin of its chip select, dwSpeed the speed it accepts
+	void Begin(uint8_t accessType, uint8_t bDevSel = LCDS_DEV_DEFAULT, uint32_t dwSpeed = LCDS_SPD_DEFAULT);
+	//initializes the driver to send the bytes through a user function, e.g. LCDSEmu::Send
+	void Begin(PFNLCDSSEND pfnSend, void* pvCtx);
 	//sets the enable/disable display options
 	void DisplaySet(boolean setDisplay, boolean setBckl);
 	//sets the cursor mode, with blink or not
@@ -93,6 +224,14 @@ public:
 	void DisplayClear();
 	//writes a string at a specified position
 	uint8_t WriteStringAtPos(uint8_t idxRow, uint8_t idxCol, char* strLn);  
+	//writes a string of known length at a specified position
+	uint8_t WriteStringAtPos(uint8_t idxRow, uint8_t idxCol, const char* pchText, uint8_t cchText);
+	//writes a number at a specified position, right aligned, with a fixed number of decimals
+	uint8_t WriteNumberAtPos(uint8_t idxRow, uint8_t idxCol, int32_t lValue, uint8_t cchWidth = 0, uint8_t cDecimals = 0);
+	//writes characters at the cursor, used by the print functions
+	virtual size_t write(uint8_t bChar);
+	virtual size_t write(const uint8_t* rgbText, size_t cbText);
+	using Print::write;
 	//scrolls the text to the left or right
 	uint8_t DisplayScroll(boolean fDirection, uint8_t idxCol);
 	//saves cursor position
@@ -111,6 +250,11 @@ public:
 	void SaveTWIAddr(uint8_t addrEeprom);
 	//saves the baud rate value to a location in the EEPROM memory
 	uint8_t SaveBR(uint8_t baudRate);
+	//moves the display and the port to a faster speed, falling back to a slower one,
+	//dwSpeedCur is the baud rate the display uses now on UART
+	uint8_t NegotiateSpeed(uint32_t dwSpeed, uint32_t dwSpeedCur = LCDS_SPD_DEFAULT);
+	//speed of the port: baud rate, TWI or SPI clock
+	uint32_t GetSpeed();
 	//programs a character table into LCD
 	uint8_t CharsToLcd(uint8_t charTable);
 	//saves a RAM character table to EEPROM
@@ -127,19 +271,241 @@ public:
 	uint8_t SaveDisplayToEeprom(uint8_t modeDisp);
 	//defines a character in the memory positioned at a specified location
 	uint8_t DefineUserChar(uint8_t* strUserDef, uint8_t charPos);
+	//defines consecutive characters in the memory in one batch
+	uint8_t DefineUserChars(const uint8_t* rgbUserDefs, uint8_t charPosFirst, uint8_t charNumber);
 	//displays a user defined char
 	uint8_t DispUserChar(uint8_t* charPos, uint8_t charNumber, uint8_t idxRow, uint8_t idxCol);
 	//sets the position of the cursor
 	uint8_t SetPos(uint8_t idxRow, uint8_t idxCol);
 	//builds the array format to be sent to the LCD
 	void BuildUserDefChar(uint8_t* strUserDef, char* cmdStr);
+	//makes a row show a text, with the cheapest mix of erase commands and characters
+	uint8_t UpdateRow(uint8_t idxRow, const char* szRow);
+	//makes both rows show a text, also considering a display clear
+	void UpdateDisplay(const char* szRow0, const char* szRow1);
+	//makes the visible columns show a text, scrolling the display when it is cheaper
+	void UpdateVisible(const char* szRow0, const char* szRow1);
+	//enables or disables sending only the characters that changed
+	void ShadowEnable(boolean fEnable);
+	//forgets the content of the display, e.g. after it was power cycled
+	void ShadowInvalidate();
+	//forgets the device settings and the display content, so the next commands are all sent
+	void ForceResync();
+	//number of times ForceResync was called, e.g. after a command was dropped
+	uint16_t GetResyncCount();
+	//tells if a character may be in the display RAM, true when the shadow does not know
+	boolean IsCharOnScreen(uint8_t bChar);
+	//starts collecting commands to send them in fewer transactions
+	void BeginBatch();
+	//sends the commands collected since BeginBatch, returns the transactions saved
+	uint16_t Flush();
+	//returns the total number of transactions saved by batching
+	uint32_t GetTransSaved();
+	//queues the commands and returns at once, Poll sends them
+	void AsyncEnable(boolean fEnable, uint8_t modeFull = LCDS_TXQ_BLOCK, uint8_t cbPoll = LCDS_TXQ_CHUNK);
+	//sends a part of the transmit queue, returns the number of bytes left
+	uint16_t Poll();
+	//transmit queue statistics
+	uint16_t GetQueueDepth();
+	uint16_t GetQueueHighWater();
+	uint32_t GetQueueDrops();
+	//sets the number of bytes the Wire library can send in one transmission
+	void SetI2CBufLen(uint8_t cbBuf);
+	//sends each SPI transaction in one buffer transfer, or byte by byte with a gap in us
+	void SetSPIBurst(boolean fBurst, uint8_t usByteGap = 0);
+	//tells if the device is still processing a slow command
+	boolean IsBusy();
+	//returns the total time spent waiting for slow commands, in us
+	uint32_t GetPaceWait();
+	//copies the bus statistics, returns false when they are not compiled in
+	boolean Stats(LCDS_STATS* pstats, boolean fReset);
   private:
+	//sends a string of bytes, or adds it to the current batch
+	void SendBytes(const uint8_t* rgbSnd, uint8_t cbSnd);
+	//sends the batch buffer, or only its full transactions
+	void SendBatch(boolean fAll);
+	//bytes in one transaction of a batch
+	uint8_t FrameLen();
+	//transactions needed to send a number of bytes
+	uint8_t TransCount(uint8_t cbSnd);
+	//sends a transaction, or adds it to the transmit queue
+	void PortSend(const uint8_t* rgbSnd, uint8_t cbSnd);
+	//makes the queued bytes of a whole command or batch visible to Poll
+	void TxqPublish();
+	//sends a string of bytes in one transaction through the selected communication port
+	void PortWrite(const uint8_t* rgbSnd, uint8_t cbSnd);
 	//sends a character or a string of characters through SPI
-	void SPISendBytes(unsigned char* dataChars, uint8_t lenght);
+	void SPISendBytes(const uint8_t* dataChars, uint8_t lenght);
+	//sends a character or a string of characters in as few I2C transmissions as possible
+	void I2CSendBytes(const uint8_t* dataChars, uint8_t lenght);
+#if defined(LCDS_STATS_ENABLE)
+	//counts a transaction put on the bus
+	void StatPort(uint8_t cbSnd, uint32_t usSnd);
+#endif
+	//waits until the slow commands the next command of a class depends on are done
+	void Pace(uint8_t fsPace);
+	//marks the end of a slow command, its settle time starts when it leaves
+	void Settle(uint8_t fsPace, uint32_t usSettle);
+	//starts the time the device needs to process a slow command just sent
+	void BusyStart(uint8_t fsPace, uint32_t usSettle);
+	//sends everything and waits until the device is done, before the port speed changes
+	void WaitIdle();
+	//sets the speed of the port on the host side
+	void PortSpeedSet(uint32_t dwSpeed);
+	//sends the commands making the device use a baud rate after its reset
+	void SendBaudChange(uint8_t idxBaud);
+	//checks that the display acknowledges its TWI address
+	boolean I2CProbe();
+	//writes the rows of a user char as hex values
+	void EncodeUserDefChar(const uint8_t* strUserDef, uint8_t* pbDst);
+	//moves the device cursor, sending the position command only when needed
+	void SendPos(uint8_t idxRow, uint8_t idxCol);
+	//moves the device cursor forward by writing again the characters it passes over
+	boolean MoveByText(uint8_t idxRow, uint8_t idxCol);
+	//bytes of the position command for a column
+	uint8_t PosCmdLen(uint8_t idxCol);
+	//moves the device cursor where the caller expects it, if it is not there
+	void SyncCursor();
+	//writes characters starting at a position, sending only the ones that changed
+	void WriteCells(uint8_t idxRow, uint8_t idxCol, const uint8_t* rgbText, uint8_t cbText);
+	//moves a position one cell forward, as the device cursor does after a character
+	void AdvancePos(uint8_t* pidxRow, uint8_t* pidxCol);
+	//updates the shadow after an erase from the cursor
+	void ShadowErase(uint8_t idxColFirst, uint8_t idxColLast);
+	//lists the erase commands that may help UpdateRow
+	uint8_t FindErases(uint8_t idxRow, const uint8_t* rgbRow, LCDS_ERASE* rgers);
+	//tells if the shadow knows that a range of columns is blank
+	boolean IsBlankKnown(uint8_t idxRow, uint8_t idxColFirst, uint8_t idxColLast);
+	//bytes sent by WriteRow, found with a dry run
+	uint16_t RowCost(uint8_t idxRow, const uint8_t* rgbRow, const LCDS_ERASE* rgers, uint8_t cers, uint32_t fsSel);
+	//sends the selected erase commands, then the characters that differ
+	void WriteRow(uint8_t idxRow, const uint8_t* rgbRow, const LCDS_ERASE* rgers, uint8_t cers, uint32_t fsSel);
+	//saves and restores the display model around a dry run
+	void SaveModel(LCDS_MODEL* pmdl);
+	void RestoreModel(const LCDS_MODEL* pmdl);
+	//scrolls the display so that it shows a column first
+	void ScrollTo(uint8_t idxScroll);
+	//writes the characters of the visible columns that differ
+	void WriteVisible(const uint8_t rgbVis[LCDS_ROWS][LCDS_VISIBLE_COLS]);
+	//number of visible cells the shadow already holds for a scroll offset
+	uint8_t VisibleMatches(uint8_t idxScroll, const uint8_t rgbVis[LCDS_ROWS][LCDS_VISIBLE_COLS]);
+	//bytes sent by ScrollTo and WriteVisible, found with a dry run
+	uint16_t VisibleCost(uint8_t idxScroll, const uint8_t rgbVis[LCDS_ROWS][LCDS_VISIBLE_COLS]);
+	boolean IsShadowKnown(uint8_t idxRow, uint8_t idxCol) {
+		return (m_rgbShadowKnown[idxRow][idxCol >> 3] & (1 << (idxCol & 7))) != 0;
+	}
+#if !defined(LCDS_NO_DSPI)
+	//statically allocated objects for the two SPI ports
+	static DSPI* GetDspi0();
+	static DSPI* GetDspi1();
+#endif
 	uint8_t m_SSPin;
+	uint8_t m_bI2CAddr;
 	uint8_t m_accessType;
+	uint32_t m_dwSpeed;
 	DSPI *pdspi;
+	PFNLCDSSEND m_pfnSend;
+	void* m_pvSendCtx;
+	//host side copy of the display RAM, with one bit per cell telling if it is known
+	uint8_t m_rgbShadow[LCDS_ROWS][LCDS_COLS];
+	uint8_t m_rgbShadowKnown[LCDS_ROWS][(LCDS_COLS + 7) / 8];
+	boolean m_fShadow;
+	//mirror of the device settings, LCDS_STATE_UNKNOWN when not known
+	uint8_t m_bDispEn;
+	uint8_t m_modeCrs;
+	uint8_t m_idxCharTable;
+	//column where the device wraps to the next row: 16, 40 or 0 when not known
+	uint8_t m_colWrap;
+	//first display RAM column shown, LCDS_STATE_UNKNOWN when not known
+	uint8_t m_idxScroll;
+	//counts the calls of ForceResync, so the users of the state know it was lost
+	uint16_t m_cResync;
+	//cursor position expected by the caller
+	uint8_t m_idxRowCrs;
+	uint8_t m_idxColCrs;
+	boolean m_fCrsKnown;
+	//position of the device cursor, which may lag behind the expected one
+	uint8_t m_idxRowDev;
+	uint8_t m_idxColDev;
+	boolean m_fDevKnown;
+	//position saved by SaveCursor
+	uint8_t m_idxRowSaved;
+	uint8_t m_idxColSaved;
+	boolean m_fSavedKnown;
+	//the cursor is shown, so it can not be left behind
+	boolean m_fCrsShown;
+	//commands batched since the outermost BeginBatch
+	uint8_t m_rgbBatch[LCDS_BATCH_MAX];
+	uint8_t m_cbBatch;
+	uint8_t m_cBatchDepth;
+	uint16_t m_cBatchSends;
+	uint16_t m_cBatchTrans;
+	uint32_t m_cTransSaved;
+	//asynchronous transmit queue, written by the commands and read by Poll
+	uint8_t m_rgbTxq[LCDS_TXQ_SIZE];
+	volatile uint16_t m_ibTxqHead;
+	volatile uint16_t m_ibTxqTail;
+	//end of the bytes queued for the command or batch not complete yet, Poll stops at m_ibTxqHead
+	uint16_t m_ibTxqPend;
+	//the last command or batch was dropped, the rest of the batch is dropped too
+	boolean m_fTxqDropped;
+	//slow commands in the transmit queue, added by Settle and removed by Poll
+	LCDS_TXQ_MARK m_rgmrkTxq[LCDS_TXQ_MARKS];
+	volatile uint8_t m_imrkHead;
+	volatile uint8_t m_imrkTail;
+	volatile boolean m_fPolling;
+	boolean m_fAsync;
+	uint8_t m_modeTxqFull;
+	uint8_t m_cbPoll;
+	uint16_t m_cbTxqHigh;
+	uint32_t m_cTxqDrop;
+	//size of one I2C transmission
+	uint8_t m_cbI2CBuf;
+	//SPI transactions sent in one buffer transfer, else byte by byte with m_usSPIGap between
+	boolean m_fSPIBurst;
+	uint8_t m_usSPIGap;
+	//classes of commands waiting for a slow command, from m_usBusyStart for m_usBusy
+	uint8_t m_fsBusy;
+	uint32_t m_usBusyStart;
+	uint32_t m_usBusy;
+	uint32_t m_usPaceWait;
+	//while not 0 the commands are only counted, in m_cbDryRun
+	uint8_t m_cDryRun;
+	uint32_t m_cbDryRun;
+	//LCDS_STATS_ENABLE changes the size of the class, so it has to be a compiler flag
+	//of the whole build, e.g. -DLCDS_STATS_ENABLE: defined only in the sketch, the
+	//sketch and LCDS.cpp would not agree on the layout of LCDS
+#if defined(LCDS_STATS_ENABLE)
+	friend class LCDSStatScope;
+	LCDS_STATS m_stats;
+	//command being executed, its bytes and transactions are counted for it
+	uint8_t m_idxStatCmd;
+#endif
+};
+
+#if defined(LCDS_STATS_ENABLE)
+//marks the command executed until the end of the scope, nested commands count for the outer one
+class LCDSStatScope {
+public:
+	LCDSStatScope(LCDS* plcds, uint8_t idxCmd) {
+		m_plcds = plcds;
+		m_idxPrev = plcds->m_idxStatCmd;
+		if (m_idxPrev == LCDS_STAT_OTHER) {
+			plcds->m_idxStatCmd = idxCmd;
+			plcds->m_stats.rgcCall[idxCmd]++;
+		}
+	}
+	~LCDSStatScope() {
+		m_plcds->m_idxStatCmd = m_idxPrev;
+	}
+private:
+	LCDS* m_plcds;
+	uint8_t m_idxPrev;
 };
+#define LCDS_STAT_CMD(idxCmd)	LCDSStatScope statScope(this, idxCmd)
+#else
+#define LCDS_STAT_CMD(idxCmd)
+#endif
 
 
 #endif
\ No newline at end of file
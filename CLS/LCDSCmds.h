@@ -0,0 +1,46 @@
+/************************************************************************/
+/*																		*/
+/*	LCDSCmds.h	--	PmodCLS command set									*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		This file defines the characters of the PmodCLS escape			*/
+/*		sequences. It is shared by the LCDS library and the emulator	*/
+/*		and has no dependency on the Arduino core.						*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: moved out of LCDS.h										*/
+/*																		*/
+/************************************************************************/
+#if !defined(LCDSCMDS_H)
+#define LCDSCMDS_H
+
+//commands for the display list
+#define ESC 					0x1B
+#define BRACKET					0x5B //[
+#define CURSOR_POS_CMD			0x48 //H
+#define CURSOR_SAVE_CMD			0x73 //s
+#define CURSOR_RSTR_CMD			0x75 //u
+#define DISP_CLR_CMD			0x6A //j
+#define ERASE_INLINE_CMD		0x4B //K
+#define ERASE_FIELD_CMD			0x4E //N
+#define LSCROLL_CMD				0x40 //@
+#define RSCROLL_CMD				0x41 //A
+#define RST_CMD					0x2A //*
+#define DISP_EN_CMD				0x65 //e
+#define DISP_MODE_CMD			0x68 //h
+#define CURSOR_MODE_CMD			0x63 //c
+#define TWI_SAVE_ADDR_CMD		0x61 //a
+#define BR_SAVE_CMD				0x62 //b
+#define PRG_CHAR_CMD			0x70 //p
+#define SAVE_RAM_TO_EEPROM_CMD	0x74 //t
+#define LD_EEPROM_TO_RAM_CMD	0x6C //l
+#define DEF_CHAR_CMD			0x64 //d
+#define COMM_MODE_SAVE_CMD		0x6D //m
+#define EEPROM_WR_EN_CMD		0x77 //w
+#define CURSOR_MODE_SAVE_CMD	0x6E //n
+#define DISP_MODE_SAVE_CMD		0x6F //o
+
+#endif
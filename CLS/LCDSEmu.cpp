@@ -0,0 +1,508 @@
+/************************************************************************/
+/*																		*/
+/*	LCDSEmu.cpp	--	Definition for the PmodCLS emulator					*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		This file defines a software model of the PmodCLS, used to		*/
+/*		check and measure the byte stream produced by the LCDS library	*/
+/*		without the device on the bench.								*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+
+/* ------------------------------------------------------------ */
+/*				Include File Definitions						*/
+/* ------------------------------------------------------------ */
+#include <string.h>
+#include "LCDSCmds.h"
+#include "LCDSEmu.h"
+
+/* ------------------------------------------------------------ */
+/*				Local Type and Constant Definitions				*/
+/* ------------------------------------------------------------ */
+//states of the escape sequence parser
+#define PARSE_TEXT		0
+#define PARSE_ESC		1
+#define PARSE_PARAM		2
+
+/* ------------------------------------------------------------ */
+/*				Procedure Definitions							*/
+/* ------------------------------------------------------------ */
+/* ------------------------------------------------------------ */
+/*        LCDSEmu::LCDSEmu
+**
+**        Description:
+**			Class constructor. Clears the EEPROM character tables and
+**			brings the emulator in the power-on state
+**
+*/
+LCDSEmu::LCDSEmu()
+{
+	memset(m_rgbCgram, 0, sizeof(m_rgbCgram));
+	m_bBaudSel = 2;
+	m_bCommSel = 0;
+	m_bTWIAddr = 0x48;
+	Reset();
+	ResetCounters();
+}
+/* ------------------------------------------------------------------- */
+/** void LCDSEmu::Reset()
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function returns the emulator to the state of the device after
+**		power-on or after the reset command. The EEPROM content is kept.
+**
+-----------------------------------------------------------------------*/
+void LCDSEmu::Reset() {
+	memset(m_rgbDdram, ' ', sizeof(m_rgbDdram));
+	memset(m_rgbCgram[LCDSEMU_TABLES - 1], 0, sizeof(m_rgbCgram[0]));
+	memcpy(m_rgbLcd, m_rgbCgram[0], sizeof(m_rgbLcd));
+	m_idxRow		= 0;
+	m_idxCol		= 0;
+	m_idxRowSaved	= 0;
+	m_idxColSaved	= 0;
+	m_idxScroll		= 0;
+	m_colWrap		= 16;
+	m_fDisplay		= true;
+	m_fBckl			= true;
+	m_fEepromWrEn	= false;
+	m_modeCrs		= 0;
+	m_idxTable		= 0;
+	m_stParse		= PARSE_TEXT;
+	m_cchParam		= 0;
+	m_cHexLeft		= 0;
+}
+/* ------------------------------------------------------------------- */
+/** void LCDSEmu::ResetCounters()
+**
+**	Description:
+**		This function clears the byte, transaction, command and error counters
+**
+-----------------------------------------------------------------------*/
+void LCDSEmu::ResetCounters() {
+	m_cbRcv		= 0;
+	m_cTrans	= 0;
+	m_cCmd		= 0;
+	m_cEepromWr	= 0;
+	m_cErr		= 0;
+}
+/* ------------------------------------------------------------------- */
+/** void LCDSEmu::Send(void* pvEmu, const uint8_t* rgbSnd, uint8_t cbSnd)
+**
+**	Parameters:
+**		pvEmu - the emulator receiving the bytes
+**		rgbSnd - the bytes of the transaction
+**		cbSnd - the number of bytes
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Send function to be given to LCDS::Begin, so that the library talks
+**		to the emulator instead of a bus. Each call is one transaction.
+**
+-----------------------------------------------------------------------*/
+void LCDSEmu::Send(void* pvEmu, const uint8_t* rgbSnd, uint8_t cbSnd) {
+	((LCDSEmu*)pvEmu)->Write(rgbSnd, cbSnd);
+}
+/* ------------------------------------------------------------------- */
+/** void LCDSEmu::Write(const uint8_t* rgbRcv, uint16_t cbRcv)
+**
+**	Parameters:
+**		rgbRcv - the bytes received by the device in one transaction
+**		cbRcv - the number of bytes
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function consumes the bytes of a bus transaction. Escape sequences
+**		may be split between transactions.
+**
+-----------------------------------------------------------------------*/
+void LCDSEmu::Write(const uint8_t* rgbRcv, uint16_t cbRcv) {
+	m_cTrans++;
+	for(uint16_t i = 0; i < cbRcv; i++) {
+		WriteByte(rgbRcv[i]);
+	}
+}
+/* ------------------------------------------------------------------- */
+/** void LCDSEmu::WriteByte(uint8_t bRcv)
+**
+**	Parameters:
+**		bRcv - the byte received by the device
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		An ESC not followed by '[', a too long or an unknown escape sequence
+**		increments the error counter
+**
+**	Description:
+**		This function runs the escape sequence parser for one byte. Bytes
+**		outside escape sequences are written in the display RAM at the cursor.
+**		The parameters are decimal digits separated by ';'. The parameters of
+**		the define character command are hex values written as 0xHH, whose
+**		digits A-F would otherwise be taken as commands.
+**
+-----------------------------------------------------------------------*/
+void LCDSEmu::WriteByte(uint8_t bRcv) {
+	m_cbRcv++;
+	switch(m_stParse) {
+		case PARSE_TEXT:
+			if (bRcv == ESC) {
+				m_stParse = PARSE_ESC;
+			}
+			else {
+				PutChar(bRcv);
+			}
+			break;
+		case PARSE_ESC:
+			if (bRcv == BRACKET) {
+				m_stParse	= PARSE_PARAM;
+				m_cchParam	= 0;
+				m_cHexLeft	= 0;
+			}
+			else {
+				m_cErr++;
+				m_stParse = PARSE_TEXT;
+			}
+			break;
+		default:
+			if (m_cHexLeft > 0 &&
+				((bRcv >= '0' && bRcv <= '9') || (bRcv >= 'A' && bRcv <= 'F') || (bRcv >= 'a' && bRcv <= 'f'))) {
+				m_cHexLeft--;
+			}
+			else if (bRcv == 'x' && m_cchParam > 0 && m_rgchParam[m_cchParam - 1] == '0') {
+				m_cHexLeft = 2;
+			}
+			else if ((bRcv >= '0' && bRcv <= '9') || bRcv == ';') {
+				m_cHexLeft = 0;
+			}
+			else {
+				//any other character terminates the sequence
+				m_stParse = PARSE_TEXT;
+				Execute(bRcv);
+				break;
+			}
+			if (m_cchParam < LCDSEMU_PARAM_MAX) {
+				m_rgchParam[m_cchParam++] = bRcv;
+			}
+			else {
+				m_cErr++;
+				m_stParse = PARSE_TEXT;
+			}
+			break;
+	}
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t LCDSEmu::ParseParams(uint16_t* rgwParam, uint8_t cParamMax)
+**
+**	Parameters:
+**		rgwParam - array receiving the values of the parameters
+**		cParamMax - the size of the array
+**
+**	Return Value:
+**		uint8_t - the number of parameters found
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function splits the parameters of the current escape sequence at
+**		';' and converts them from decimal, or from hex when they start with 0x
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDSEmu::ParseParams(uint16_t* rgwParam, uint8_t cParamMax) const {
+	uint8_t cParam = 0;
+	uint8_t ich = 0;
+	if (m_cchParam == 0) {
+		return 0;
+	}
+	while (ich <= m_cchParam && cParam < cParamMax) {
+		uint16_t wVal = 0;
+		if (ich + 1 < m_cchParam && m_rgchParam[ich] == '0' && m_rgchParam[ich + 1] == 'x') {
+			ich += 2;
+			while (ich < m_cchParam && m_rgchParam[ich] != ';') {
+				uint8_t ch = m_rgchParam[ich++];
+				wVal <<= 4;
+				if (ch >= '0' && ch <= '9')			wVal |= ch - '0';
+				else if (ch >= 'A' && ch <= 'F')	wVal |= ch - 'A' + 10;
+				else								wVal |= ch - 'a' + 10;
+			}
+		}
+		else {
+			while (ich < m_cchParam && m_rgchParam[ich] != ';') {
+				wVal = wVal * 10 + (m_rgchParam[ich++] - '0');
+			}
+		}
+		rgwParam[cParam++] = wVal;
+		//skip the separator
+		ich++;
+	}
+	return cParam;
+}
+/* ------------------------------------------------------------------- */
+/** void LCDSEmu::Execute(uint8_t bCmd)
+**
+**	Parameters:
+**		bCmd - the character ending the escape sequence
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Unknown commands, out of range parameters and saves to the EEPROM that
+**		did not follow a write enable increment the error counter
+**
+**	Description:
+**		This function applies a complete escape sequence to the emulated device.
+**		Each save to the EEPROM uses up the write enable sent before it.
+**
+-----------------------------------------------------------------------*/
+void LCDSEmu::Execute(uint8_t bCmd) {
+	uint16_t rgwParam[LCDSEMU_CHARS + 2];
+	uint8_t cParam = ParseParams(rgwParam, sizeof(rgwParam) / sizeof(rgwParam[0]));
+	uint16_t wParam = (cParam > 0) ? rgwParam[0] : 0;
+	m_cCmd++;
+	switch(bCmd) {
+		case SAVE_RAM_TO_EEPROM_CMD:
+		case BR_SAVE_CMD:
+		case COMM_MODE_SAVE_CMD:
+		case TWI_SAVE_ADDR_CMD:
+		case CURSOR_MODE_SAVE_CMD:
+		case DISP_MODE_SAVE_CMD:
+			if (!m_fEepromWrEn) {
+				m_cErr++;
+				return;
+			}
+			m_fEepromWrEn = false;
+			break;
+	}
+	switch(bCmd) {
+		case CURSOR_POS_CMD:
+			if (cParam < 2) {
+				//a single parameter is the column on the current row
+				rgwParam[1] = wParam;
+				rgwParam[0] = m_idxRow;
+			}
+			if (rgwParam[0] < LCDSEMU_ROWS && rgwParam[1] < LCDSEMU_COLS) {
+				m_idxRow = rgwParam[0];
+				m_idxCol = rgwParam[1];
+			}
+			else {
+				m_cErr++;
+			}
+			break;
+		case CURSOR_SAVE_CMD:
+			m_idxRowSaved = m_idxRow;
+			m_idxColSaved = m_idxCol;
+			break;
+		case CURSOR_RSTR_CMD:
+			m_idxRow = m_idxRowSaved;
+			m_idxCol = m_idxColSaved;
+			break;
+		case DISP_CLR_CMD:
+			memset(m_rgbDdram, ' ', sizeof(m_rgbDdram));
+			m_idxRow	= 0;
+			m_idxCol	= 0;
+			m_idxScroll	= 0;
+			break;
+		case ERASE_INLINE_CMD:
+			if (wParam == 0)		EraseCols(m_idxRow, m_idxCol, LCDSEMU_COLS - 1);
+			else if (wParam == 1)	EraseCols(m_idxRow, 0, m_idxCol);
+			else if (wParam == 2)	EraseCols(m_idxRow, 0, LCDSEMU_COLS - 1);
+			else					m_cErr++;
+			break;
+		case ERASE_FIELD_CMD:
+			if (wParam > 0) {
+				uint16_t idxLast = m_idxCol + wParam - 1;
+				EraseCols(m_idxRow, m_idxCol, (idxLast < LCDSEMU_COLS) ? idxLast : LCDSEMU_COLS - 1);
+			}
+			break;
+		case LSCROLL_CMD:
+			m_idxScroll = (m_idxScroll + wParam) % LCDSEMU_COLS;
+			break;
+		case RSCROLL_CMD:
+			m_idxScroll = (m_idxScroll + LCDSEMU_COLS - (wParam % LCDSEMU_COLS)) % LCDSEMU_COLS;
+			break;
+		case RST_CMD:
+			Reset();
+			break;
+		case DISP_EN_CMD:
+			if (wParam <= 3) {
+				m_fDisplay	= (wParam & 1) != 0;
+				m_fBckl		= (wParam & 2) != 0;
+			}
+			else {
+				m_cErr++;
+			}
+			break;
+		case DISP_MODE_CMD:
+			if (wParam <= 1)	m_colWrap = (wParam == 0) ? 16 : 40;
+			else				m_cErr++;
+			break;
+		case CURSOR_MODE_CMD:
+			if (wParam <= 2)	m_modeCrs = wParam;
+			else				m_cErr++;
+			break;
+		case PRG_CHAR_CMD:
+			if (wParam < LCDSEMU_TABLES) {
+				memcpy(m_rgbLcd, m_rgbCgram[wParam], sizeof(m_rgbLcd));
+				m_idxTable = wParam;
+			}
+			else {
+				m_cErr++;
+			}
+			break;
+		case DEF_CHAR_CMD:
+			//8 rows of the pattern followed by the position of the character
+			if (cParam == 9 && rgwParam[8] < LCDSEMU_CHARS) {
+				for(uint8_t i = 0; i < 8; i++) {
+					m_rgbCgram[LCDSEMU_TABLES - 1][rgwParam[8]][i] = (uint8_t)rgwParam[i];
+				}
+			}
+			else {
+				m_cErr++;
+			}
+			break;
+		case LD_EEPROM_TO_RAM_CMD:
+			if (wParam < LCDSEMU_TABLES - 1) {
+				memcpy(m_rgbCgram[LCDSEMU_TABLES - 1], m_rgbCgram[wParam], sizeof(m_rgbCgram[0]));
+			}
+			else {
+				m_cErr++;
+			}
+			break;
+		case EEPROM_WR_EN_CMD:
+			m_fEepromWrEn = true;
+			break;
+		case SAVE_RAM_TO_EEPROM_CMD:
+			m_cEepromWr++;
+			if (wParam < LCDSEMU_TABLES - 1) {
+				memcpy(m_rgbCgram[wParam], m_rgbCgram[LCDSEMU_TABLES - 1], sizeof(m_rgbCgram[0]));
+			}
+			break;
+		case BR_SAVE_CMD:
+			m_cEepromWr++;
+			if (wParam <= 6)	m_bBaudSel = wParam;
+			else				m_cErr++;
+			break;
+		case COMM_MODE_SAVE_CMD:
+			m_cEepromWr++;
+			if (wParam <= 7)	m_bCommSel = wParam;
+			else				m_cErr++;
+			break;
+		case TWI_SAVE_ADDR_CMD:
+			m_cEepromWr++;
+			m_bTWIAddr = wParam;
+			break;
+		case CURSOR_MODE_SAVE_CMD:
+		case DISP_MODE_SAVE_CMD:
+			m_cEepromWr++;
+			break;
+		default:
+			m_cErr++;
+			break;
+	}
+}
+/* ------------------------------------------------------------------- */
+/** void LCDSEmu::PutChar(uint8_t bChar)
+**
+**	Parameters:
+**		bChar - the character to be written
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function writes a character at the cursor and advances it. The
+**		cursor moves to the start of the other row when it reaches the wrap
+**		column selected with the display mode command, or the end of the row.
+**
+-----------------------------------------------------------------------*/
+void LCDSEmu::PutChar(uint8_t bChar) {
+	m_rgbDdram[m_idxRow][m_idxCol++] = bChar;
+	if (m_idxCol == m_colWrap || m_idxCol == LCDSEMU_COLS) {
+		m_idxCol = 0;
+		m_idxRow = (m_idxRow + 1) % LCDSEMU_ROWS;
+	}
+}
+/* ------------------------------------------------------------------- */
+/** void LCDSEmu::EraseCols(uint8_t idxRow, uint8_t idxColFirst, uint8_t idxColLast)
+**
+**	Description:
+**		This function fills the columns idxColFirst to idxColLast of a row with spaces
+**
+-----------------------------------------------------------------------*/
+void LCDSEmu::EraseCols(uint8_t idxRow, uint8_t idxColFirst, uint8_t idxColLast) {
+	for(uint8_t i = idxColFirst; i <= idxColLast; i++) {
+		m_rgbDdram[idxRow][i] = ' ';
+	}
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t LCDSEmu::CharAt(uint8_t idxRow, uint8_t idxCol)
+**
+**	Return Value:
+**		uint8_t - the character in the display RAM, 0 when out of range
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDSEmu::CharAt(uint8_t idxRow, uint8_t idxCol) const {
+	if (idxRow >= LCDSEMU_ROWS || idxCol >= LCDSEMU_COLS) {
+		return 0;
+	}
+	return m_rgbDdram[idxRow][idxCol];
+}
+/* ------------------------------------------------------------------- */
+/** void LCDSEmu::GetVisibleRow(uint8_t idxRow, char* szRow)
+**
+**	Parameters:
+**		idxRow - the row to be copied
+**		szRow - buffer of at least LCDSEMU_VISIBLE_COLS + 1 characters
+**
+**	Description:
+**		This function copies the characters shown on a row of the LCD, taking
+**		the scrolling of the display into account
+**
+-----------------------------------------------------------------------*/
+void LCDSEmu::GetVisibleRow(uint8_t idxRow, char* szRow) const {
+	for(uint8_t i = 0; i < LCDSEMU_VISIBLE_COLS; i++) {
+		szRow[i] = CharAt(idxRow, (m_idxScroll + i) % LCDSEMU_COLS);
+	}
+	szRow[LCDSEMU_VISIBLE_COLS] = 0;
+}
+/* ------------------------------------------------------------------- */
+/** const uint8_t* LCDSEmu::Glyph(uint8_t idxChar)
+**
+**	Return Value:
+**		const uint8_t* - the 8 rows of the user defined char as programmed in the LCD
+**
+-----------------------------------------------------------------------*/
+const uint8_t* LCDSEmu::Glyph(uint8_t idxChar) const {
+	return m_rgbLcd[idxChar % LCDSEMU_CHARS];
+}
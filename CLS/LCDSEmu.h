@@ -0,0 +1,118 @@
+/************************************************************************/
+/*																		*/
+/*	LCDSEmu.h	--	Declaration for the PmodCLS emulator				*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		This file declares a software model of the PmodCLS. It parses	*/
+/*		the same byte stream the LCDS library sends to the device and	*/
+/*		keeps the display RAM, the cursor and the character tables.		*/
+/*		It does not depend on the Arduino core, so it can be built on	*/
+/*		a host as well as on the board.									*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+#if !defined(LCDSEMU_H)
+#define LCDSEMU_H
+
+/* ------------------------------------------------------------ */
+/*				Include File Definitions						*/
+/* ------------------------------------------------------------ */
+#include <inttypes.h>
+
+//geometry of the display RAM
+#define LCDSEMU_ROWS			2
+#define LCDSEMU_COLS			40
+#define LCDSEMU_VISIBLE_COLS	16
+//number of user defined characters and tables
+#define LCDSEMU_CHARS			8
+#define LCDSEMU_TABLES			4
+//maximum length of the parameters of an escape sequence
+#define LCDSEMU_PARAM_MAX		64
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+
+class LCDSEmu {
+public:
+	LCDSEmu();
+	//returns the emulator to the power-on state
+	void Reset();
+	//consumes the bytes of one bus transaction
+	void Write(const uint8_t* rgbRcv, uint16_t cbRcv);
+	//consumes a single byte
+	void WriteByte(uint8_t bRcv);
+	//send function that can be passed to LCDS::Begin, pvEmu is the emulator
+	static void Send(void* pvEmu, const uint8_t* rgbSnd, uint8_t cbSnd);
+	//returns the character stored in the display RAM at a position
+	uint8_t CharAt(uint8_t idxRow, uint8_t idxCol) const;
+	//copies the 16 visible characters of a row, as shifted by scrolling
+	void GetVisibleRow(uint8_t idxRow, char* szRow) const;
+	//returns the pattern of a user defined char as shown by the LCD
+	const uint8_t* Glyph(uint8_t idxChar) const;
+	//device state
+	uint8_t CursorRow() const		{ return m_idxRow; }
+	uint8_t CursorCol() const		{ return m_idxCol; }
+	uint8_t ScrollOffset() const	{ return m_idxScroll; }
+	uint8_t WrapCols() const		{ return m_colWrap; }
+	bool DisplayOn() const			{ return m_fDisplay; }
+	bool BacklightOn() const		{ return m_fBckl; }
+	uint8_t CursorMode() const		{ return m_modeCrs; }
+	uint8_t ActiveTable() const		{ return m_idxTable; }
+	//EEPROM settings written by the host
+	uint8_t EepromBaud() const		{ return m_bBaudSel; }
+	uint8_t EepromComm() const		{ return m_bCommSel; }
+	uint8_t EepromTWIAddr() const	{ return m_bTWIAddr; }
+	//counters
+	uint32_t Bytes() const			{ return m_cbRcv; }
+	uint32_t Transactions() const	{ return m_cTrans; }
+	uint32_t Commands() const		{ return m_cCmd; }
+	uint32_t EepromWrites() const	{ return m_cEepromWr; }
+	uint32_t Errors() const			{ return m_cErr; }
+	void ResetCounters();
+private:
+	//executes a complete escape sequence
+	void Execute(uint8_t bCmd);
+	//splits the parameters, returns their number
+	uint8_t ParseParams(uint16_t* rgwParam, uint8_t cParamMax) const;
+	//writes a character at the cursor and advances it
+	void PutChar(uint8_t bChar);
+	//fills a part of a row with spaces
+	void EraseCols(uint8_t idxRow, uint8_t idxColFirst, uint8_t idxColLast);
+
+	uint8_t m_rgbDdram[LCDSEMU_ROWS][LCDSEMU_COLS];
+	uint8_t m_rgbCgram[LCDSEMU_TABLES][LCDSEMU_CHARS][8];
+	uint8_t m_rgbLcd[LCDSEMU_CHARS][8];
+	uint8_t m_idxRow;
+	uint8_t m_idxCol;
+	uint8_t m_idxRowSaved;
+	uint8_t m_idxColSaved;
+	uint8_t m_idxScroll;
+	uint8_t m_colWrap;
+	bool	m_fDisplay;
+	bool	m_fBckl;
+	bool	m_fEepromWrEn;
+	uint8_t m_modeCrs;
+	uint8_t m_idxTable;
+	uint8_t m_bBaudSel;
+	uint8_t m_bCommSel;
+	uint8_t m_bTWIAddr;
+	//escape sequence parser
+	uint8_t m_stParse;
+	uint8_t m_rgchParam[LCDSEMU_PARAM_MAX];
+	uint8_t m_cchParam;
+	uint8_t m_cHexLeft;
+	//counters
+	uint32_t m_cbRcv;
+	uint32_t m_cTrans;
+	uint32_t m_cCmd;
+	uint32_t m_cEepromWr;
+	uint32_t m_cErr;
+};
+
+#endif
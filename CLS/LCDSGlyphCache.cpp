@@ -0,0 +1,274 @@
+/************************************************************************/
+/*																		*/
+/*	LCDSGlyphCache.cpp	--	Definition for the user char cache			*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		This file defines a cache of the user defined characters of		*/
+/*		the PmodCLS, built on DefineUserChars and DispUserChar.			*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+
+/* ------------------------------------------------------------ */
+/*				Include File Definitions						*/
+/* ------------------------------------------------------------ */
+#include <string.h>
+#include "LCDSGlyphCache.h"
+
+/* ------------------------------------------------------------ */
+/*				Procedure Definitions							*/
+/* ------------------------------------------------------------ */
+/* ------------------------------------------------------------ */
+/*        LCDSGlyphCache::LCDSGlyphCache
+**
+**        Description:
+**			Class constructor. The cache is empty and not attached
+**			to a display until Begin is called.
+**
+*/
+LCDSGlyphCache::LCDSGlyphCache()
+{
+	m_plcds = NULL;
+	m_cResync = 0;
+	m_idxSlotFirst = 0;
+	m_cSlot = 0;
+	Invalidate();
+	ResetCounters();
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t LCDSGlyphCache::Begin(LCDS* plcds, uint8_t idxSlotFirst, uint8_t cSlot)
+**
+**	Parameters:
+**		plcds - the display, already initialized
+**		idxSlotFirst - the first user char managed by the cache
+**		cSlot - the number of user chars managed by the cache
+**
+**	Return Value:
+**		uint8_t
+**					- LCDS_ERR_SUCCESS - The action completed successfully
+**					- LCDS_ERR_ARG_POS_RANGE - The user chars are not within 0, 7 range
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function attaches the cache to a display. The user chars outside of
+**		the range can still be defined by the application with DefineUserChar.
+**		The cache starts empty, so the first use of each glyph defines it.
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDSGlyphCache::Begin(LCDS* plcds, uint8_t idxSlotFirst, uint8_t cSlot) {
+	if (cSlot == 0 || idxSlotFirst >= LCDS_GLYPH_SLOTS || cSlot > LCDS_GLYPH_SLOTS - idxSlotFirst) {
+		return LCDS_ERR_ARG_POS_RANGE;
+	}
+	m_plcds = plcds;
+	m_idxSlotFirst = idxSlotFirst;
+	m_cSlot = cSlot;
+	m_cResync = plcds->GetResyncCount();
+	Invalidate();
+	return LCDS_ERR_SUCCESS;
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t LCDSGlyphCache::LoadGlyph(const uint8_t* rgbGlyph, uint8_t* pbChar)
+**
+**	Parameters:
+**		rgbGlyph - the 8 rows of the glyph
+**		pbChar - receives the user char showing the glyph
+**
+**	Return Value:
+**		uint8_t
+**					- LCDS_ERR_SUCCESS - The action completed successfully
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function looks for the glyph in the slots. On a hit nothing is sent.
+**		On a miss the glyph is defined in an empty slot, or in the slot used least
+**		recently that is not displayed. When all the slots are displayed, the
+**		least recently used one is replaced anyway, changing the cells showing it.
+**		The char returned can be written with DispUserChar or WriteStringAtPos.
+**		The cache is emptied when the display forgot its state, e.g. after Reset
+**		or a command dropped by the transmit queue, including the define itself.
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDSGlyphCache::LoadGlyph(const uint8_t* rgbGlyph, uint8_t* pbChar) {
+	uint16_t wHash = Hash(rgbGlyph);
+	uint8_t idxSlot;
+	if (m_plcds->GetResyncCount() != m_cResync) {
+		m_cResync = m_plcds->GetResyncCount();
+		Invalidate();
+	}
+	m_tUse++;
+	for (idxSlot = 0; idxSlot < m_cSlot; idxSlot++) {
+		if ((m_fsValid & (1 << idxSlot)) && m_rgwHash[idxSlot] == wHash &&
+			memcmp(m_rgbGlyph[idxSlot], rgbGlyph, LCDS_GLYPH_LEN) == 0) {
+			m_cHit++;
+			m_rgtUse[idxSlot] = m_tUse;
+			*pbChar = m_idxSlotFirst + idxSlot;
+			return LCDS_ERR_SUCCESS;
+		}
+	}
+	m_cMiss++;
+	idxSlot = Victim();
+	if (m_fsValid & (1 << idxSlot)) {
+		m_cEvict++;
+	}
+	m_plcds->DefineUserChars(rgbGlyph, m_idxSlotFirst + idxSlot, 1);
+	if (m_plcds->GetResyncCount() == m_cResync) {
+		memcpy(m_rgbGlyph[idxSlot], rgbGlyph, LCDS_GLYPH_LEN);
+		m_rgwHash[idxSlot] = wHash;
+		m_fsValid |= 1 << idxSlot;
+		m_rgtUse[idxSlot] = m_tUse;
+	}
+	else {
+		//the define was dropped, the next use defines the glyph again
+		m_cResync = m_plcds->GetResyncCount();
+		Invalidate();
+	}
+	*pbChar = m_idxSlotFirst + idxSlot;
+	return LCDS_ERR_SUCCESS;
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t LCDSGlyphCache::DispGlyph(const uint8_t* rgbGlyph, uint8_t idxRow, uint8_t idxCol)
+**
+**	Parameters:
+**		rgbGlyph - the 8 rows of the glyph
+**		idxRow - the row at which the glyph should be displayed
+**		idxCol - the column at which the glyph should be displayed
+**
+**	Return Value:
+**		uint8_t
+**					- LCDS_ERR_SUCCESS - The action completed successfully
+**					- the errors of DispUserChar
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function loads the glyph and displays its user char. When the glyph
+**		is already loaded and displayed at the position, nothing is sent.
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDSGlyphCache::DispGlyph(const uint8_t* rgbGlyph, uint8_t idxRow, uint8_t idxCol) {
+	uint8_t bChar;
+	uint8_t bResult = LoadGlyph(rgbGlyph, &bChar);
+	if (bResult == LCDS_ERR_SUCCESS) {
+		bResult = m_plcds->DispUserChar(&bChar, 1, idxRow, idxCol);
+	}
+	return bResult;
+}
+/* ------------------------------------------------------------------- */
+/** void LCDSGlyphCache::Invalidate()
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function empties the cache. It has to be called after the user chars
+**		were changed without the cache, e.g. by CharsToLcd or DefineUserChar on a
+**		slot managed by the cache. After Reset or ForceResync the cache empties
+**		itself.
+**
+-----------------------------------------------------------------------*/
+void LCDSGlyphCache::Invalidate() {
+	m_fsValid = 0;
+	m_tUse = 0;
+	memset(m_rgtUse, 0, sizeof(m_rgtUse));
+}
+/* ------------------------------------------------------------------- */
+/** uint32_t LCDSGlyphCache::GetHits()
+**
+**	Description:
+**		Returns the number of glyphs that were found in the cache, GetMisses the
+**		number that had to be defined and GetEvictions the number of those that
+**		replaced another glyph.
+**
+-----------------------------------------------------------------------*/
+uint32_t LCDSGlyphCache::GetHits() {
+	return m_cHit;
+}
+
+uint32_t LCDSGlyphCache::GetMisses() {
+	return m_cMiss;
+}
+
+uint32_t LCDSGlyphCache::GetEvictions() {
+	return m_cEvict;
+}
+
+void LCDSGlyphCache::ResetCounters() {
+	m_cHit = 0;
+	m_cMiss = 0;
+	m_cEvict = 0;
+}
+/* ------------------------------------------------------------------- */
+/** uint16_t LCDSGlyphCache::Hash(const uint8_t* rgbGlyph)
+**
+**	Parameters:
+**		rgbGlyph - the 8 rows of the glyph
+**
+**	Return Value:
+**		uint16_t - the hash of the rows
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function computes a 16 bit FNV-1a hash of the rows
+**
+-----------------------------------------------------------------------*/
+uint16_t LCDSGlyphCache::Hash(const uint8_t* rgbGlyph) {
+	uint32_t dwHash = 2166136261UL;
+	for (uint8_t i = 0; i < LCDS_GLYPH_LEN; i++) {
+		dwHash = (dwHash ^ rgbGlyph[i]) * 16777619UL;
+	}
+	return (uint16_t)(dwHash ^ (dwHash >> 16));
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t LCDSGlyphCache::Victim()
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		uint8_t - the index of the slot, relative to the first slot of the cache
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function returns an empty slot if there is one. Otherwise it returns
+**		the least recently used slot whose char the display shadow does not show,
+**		or the least recently used slot when all of them may be displayed.
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDSGlyphCache::Victim() {
+	uint8_t idxLru = 0;
+	uint8_t idxFree = 0xFF;
+	for (uint8_t idxSlot = 0; idxSlot < m_cSlot; idxSlot++) {
+		if (!(m_fsValid & (1 << idxSlot))) {
+			return idxSlot;
+		}
+		if (m_rgtUse[idxSlot] < m_rgtUse[idxLru]) {
+			idxLru = idxSlot;
+		}
+		if (!m_plcds->IsCharOnScreen(m_idxSlotFirst + idxSlot) &&
+			(idxFree == 0xFF || m_rgtUse[idxSlot] < m_rgtUse[idxFree])) {
+			idxFree = idxSlot;
+		}
+	}
+	return (idxFree != 0xFF) ? idxFree : idxLru;
+}
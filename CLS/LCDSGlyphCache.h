@@ -0,0 +1,75 @@
+/************************************************************************/
+/*																		*/
+/*	LCDSGlyphCache.h	--	Declaration for the user char cache			*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		This file declares a cache of the user defined characters of	*/
+/*		the PmodCLS. The device has only 8 of them, so the glyphs used	*/
+/*		by an application are loaded on demand, replacing the least		*/
+/*		recently used glyph that is not displayed.						*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+#if !defined(LCDSGLYPHCACHE_H)
+#define LCDSGLYPHCACHE_H
+
+/* ------------------------------------------------------------ */
+/*				Include File Definitions						*/
+/* ------------------------------------------------------------ */
+#include "LCDS.h"
+
+//number of user defined characters of the device
+#define LCDS_GLYPH_SLOTS		8
+//number of bytes of a glyph, one for each row
+#define LCDS_GLYPH_LEN			8
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+
+class LCDSGlyphCache {
+public:
+	LCDSGlyphCache();
+	//uses the user chars from idxSlotFirst to idxSlotFirst + cSlot - 1 of a display
+	uint8_t Begin(LCDS* plcds, uint8_t idxSlotFirst = 0, uint8_t cSlot = LCDS_GLYPH_SLOTS);
+	//returns in pbChar the user char showing a glyph, defining it if needed
+	uint8_t LoadGlyph(const uint8_t* rgbGlyph, uint8_t* pbChar);
+	//displays a glyph at a position, defining it if needed
+	uint8_t DispGlyph(const uint8_t* rgbGlyph, uint8_t idxRow, uint8_t idxCol);
+	//forgets the glyphs, e.g. after the character table was changed
+	void Invalidate();
+	//statistics
+	uint32_t GetHits();
+	uint32_t GetMisses();
+	uint32_t GetEvictions();
+	void ResetCounters();
+private:
+	//hash of the rows of a glyph
+	static uint16_t Hash(const uint8_t* rgbGlyph);
+	//chooses the slot that receives a new glyph
+	uint8_t Victim();
+
+	LCDS* m_plcds;
+	//resync count of the display when the slots were last known to be right
+	uint16_t m_cResync;
+	uint8_t m_idxSlotFirst;
+	uint8_t m_cSlot;
+	//glyph held by each slot, with its hash to skip most compares
+	uint8_t m_rgbGlyph[LCDS_GLYPH_SLOTS][LCDS_GLYPH_LEN];
+	uint16_t m_rgwHash[LCDS_GLYPH_SLOTS];
+	uint8_t m_fsValid;
+	//time of the last use of each slot
+	uint32_t m_rgtUse[LCDS_GLYPH_SLOTS];
+	uint32_t m_tUse;
+	//counters
+	uint32_t m_cHit;
+	uint32_t m_cMiss;
+	uint32_t m_cEvict;
+};
+
+#endif
@@ -0,0 +1,155 @@
+/************************************************************************/
+/*																		*/
+/*	LCDSGroup.cpp	--	Definition for a group of PmodCLS displays		*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		This file defines a scheduler for several PmodCLS displays,		*/
+/*		built on the transmit queues of LCDS.							*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+
+/* ------------------------------------------------------------ */
+/*				Include File Definitions						*/
+/* ------------------------------------------------------------ */
+#include "LCDSGroup.h"
+
+/* ------------------------------------------------------------ */
+/*				Procedure Definitions							*/
+/* ------------------------------------------------------------ */
+/* ------------------------------------------------------------ */
+/*        LCDSGroup::LCDSGroup
+**
+**        Description:
+**			Class constructor. The group starts empty.
+**
+*/
+LCDSGroup::LCDSGroup()
+{
+	m_cDisp = 0;
+	m_idxTurn = 0;
+	m_cChunkTurn = 0;
+}
+/* ------------------------------------------------------------------- */
+/** uint8_t LCDSGroup::Add(LCDS* plcds, uint8_t bWeight)
+**
+**	Parameters:
+**		plcds - the display, initialized with Begin
+**		bWeight - the number of chunks the display can send in its turn, at least 1
+**
+**	Return Value:
+**		uint8_t
+**					- LCDS_ERR_SUCCESS - The action completed successfully
+**					- LCDS_ERR_GROUP_FULL - The group already holds LCDS_GROUP_MAX displays
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function adds a display to the group and puts it in asynchronous mode,
+**		so its commands return at once and are sent by the Poll of the group.
+**		The displays can be on different ports, or on the same port with their
+**		own TWI addresses or chip selects. A higher weight gives a display a
+**		larger share of the bus, every display still sends in each round.
+**
+-----------------------------------------------------------------------*/
+uint8_t LCDSGroup::Add(LCDS* plcds, uint8_t bWeight) {
+	if (m_cDisp >= LCDS_GROUP_MAX) {
+		return LCDS_ERR_GROUP_FULL;
+	}
+	plcds->AsyncEnable(true);
+	m_rgplcds[m_cDisp] = plcds;
+	m_rgbWeight[m_cDisp] = (bWeight > 0) ? bWeight : 1;
+	m_rgcbSent[m_cDisp] = 0;
+	m_cDisp++;
+	return LCDS_ERR_SUCCESS;
+}
+/* ------------------------------------------------------------------- */
+/** uint16_t LCDSGroup::Poll(uint16_t cbBudget)
+**
+**	Parameters:
+**		cbBudget - the number of bytes that can be sent by this call
+**
+**	Return Value:
+**		uint16_t - the number of bytes still waiting in the queues
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function sends the queued bytes of the displays in weighted round
+**		robin: each display sends up to its weight in chunks, one transaction
+**		each, then the next display has its turn. A display with nothing to send,
+**		or that holds its queue while the device processes a slow command, loses
+**		its turn at once. The function returns once the budget is used or no
+**		display can send; the next call goes on with the display whose turn it was,
+**		so a small budget is shared fairly across calls. It is meant to be called
+**		from loop() or from a periodic interrupt service routine.
+**
+-----------------------------------------------------------------------*/
+uint16_t LCDSGroup::Poll(uint16_t cbBudget) {
+	uint8_t cIdle = 0;
+	while (cbBudget > 0 && cIdle < m_cDisp) {
+		LCDS* plcds = m_rgplcds[m_idxTurn];
+		uint16_t cbSent = plcds->GetQueueDepth();
+		if (cbSent > 0) {
+			cbSent -= plcds->Poll();
+		}
+		if (cbSent > 0) {
+			cIdle = 0;
+			m_rgcbSent[m_idxTurn] += cbSent;
+			cbBudget = (cbSent < cbBudget) ? cbBudget - cbSent : 0;
+		}
+		else {
+			cIdle++;
+		}
+		if (cbSent == 0 || ++m_cChunkTurn >= m_rgbWeight[m_idxTurn]) {
+			m_cChunkTurn = 0;
+			m_idxTurn = (m_idxTurn + 1) % m_cDisp;
+		}
+	}
+	return GetQueueDepth();
+}
+/* ------------------------------------------------------------------- */
+/** void LCDSGroup::Drain()
+**
+**	Description:
+**		Polls until the queues of all the displays are empty, e.g. before
+**		going to sleep
+**
+-----------------------------------------------------------------------*/
+void LCDSGroup::Drain() {
+	while (Poll() > 0) {
+	}
+}
+/* ------------------------------------------------------------------- */
+/** uint16_t LCDSGroup::GetQueueDepth()
+**	uint32_t LCDSGroup::GetBytesSent(uint8_t idxDisp)
+**	uint8_t LCDSGroup::GetCount()
+**
+**	Description:
+**		Return the bytes waiting in all the queues, the bytes sent by Poll for
+**		the display added in position idxDisp, and the number of displays
+**
+-----------------------------------------------------------------------*/
+uint16_t LCDSGroup::GetQueueDepth() {
+	uint16_t cb = 0;
+	for (uint8_t idxDisp = 0; idxDisp < m_cDisp; idxDisp++) {
+		cb += m_rgplcds[idxDisp]->GetQueueDepth();
+	}
+	return cb;
+}
+
+uint32_t LCDSGroup::GetBytesSent(uint8_t idxDisp) {
+	return (idxDisp < m_cDisp) ? m_rgcbSent[idxDisp] : 0;
+}
+
+uint8_t LCDSGroup::GetCount() {
+	return m_cDisp;
+}
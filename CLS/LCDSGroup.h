@@ -0,0 +1,61 @@
+/************************************************************************/
+/*																		*/
+/*	LCDSGroup.h		--	Declaration for a group of PmodCLS displays		*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		This file declares a scheduler for several PmodCLS displays		*/
+/*		driven by one controller. Each display has its own LCDS object	*/
+/*		in asynchronous mode; the group drains their transmit queues	*/
+/*		in turn, so that a display with a lot to send, or one waiting	*/
+/*		for a slow command, does not hold up the others.				*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+#if !defined(LCDSGROUP_H)
+#define LCDSGROUP_H
+
+/* ------------------------------------------------------------ */
+/*				Include File Definitions						*/
+/* ------------------------------------------------------------ */
+#include "LCDS.h"
+
+//number of displays in a group
+#define LCDS_GROUP_MAX			8
+//default number of bytes sent by each Poll of the group
+#define LCDS_GROUP_BUDGET		64
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+
+class LCDSGroup {
+public:
+	LCDSGroup();
+	//adds a display, already initialized; a weight of n lets it send n chunks in its turn
+	uint8_t Add(LCDS* plcds, uint8_t bWeight = 1);
+	//sends up to cbBudget queued bytes, the displays taking turns, returns the bytes left
+	uint16_t Poll(uint16_t cbBudget = LCDS_GROUP_BUDGET);
+	//polls until all the queues are empty
+	void Drain();
+	//number of bytes waiting in all the queues
+	uint16_t GetQueueDepth();
+	//number of bytes sent for a display by Poll
+	uint32_t GetBytesSent(uint8_t idxDisp);
+	//number of displays
+	uint8_t GetCount();
+private:
+	LCDS* m_rgplcds[LCDS_GROUP_MAX];
+	uint8_t m_rgbWeight[LCDS_GROUP_MAX];
+	uint32_t m_rgcbSent[LCDS_GROUP_MAX];
+	uint8_t m_cDisp;
+	//display whose turn it is, and the chunks it sent in this turn
+	uint8_t m_idxTurn;
+	uint8_t m_cChunkTurn;
+};
+
+#endif
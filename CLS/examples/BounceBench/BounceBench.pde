@@ -0,0 +1,154 @@
+/************************************************************************/
+/*                                                                      */
+/*  BounceBench                                                         */
+/*                                                                      */
+/************************************************************************/
+/*  Module Description:                                                 */
+/*                                                                      */
+/* This sketch measures the cost of debouncing 32 inputs: with one      */
+/* Bounce object for each input updated one by one, with the same       */
+/* objects updated by Bounce::updateAll at one time for all of them,    */
+/* and with one BounceBank.                                             */
+/*                                                                      */
+/*  Functionality:                                                      */
+/*                                                                      */
+/* Pins FIRST_PIN to FIRST_PIN + 31 are set as inputs. Each debouncer   */
+/* is updated for UPDATE_COUNT rounds, and the sketch prints a CSV line */
+/* for each with the average time of a round and of one input in us,    */
+/* and the number of clock reads for one input. The clock is counted    */
+/* through Bounce::setClock, so the last column does not depend on the  */
+/* board. The bounce_bank line mostly times the updates that return     */
+/* before the next sample is due, so bounce_bank_sample runs the bank   */
+/* on a clock that moves by one sample period at each read, and every   */
+/* update samples the inputs. The inputs do not have to be connected.   */
+/*                                                                      */
+/*  Required Hardware:                                                  */
+/*      1. any chipKIT board with 32 digital pins from FIRST_PIN        */
+/*                                                                      */
+/************************************************************************/
+/*  Revision History:                                                   */
+/*                                                                      */
+/*  10/17/2026: created                                                 */
+/*                                                                      */
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*              Include File Definitions                        */
+/* ------------------------------------------------------------ */
+#include <Bounce.h>
+#include <BounceBank.h>
+/* ------------------------------------------------------------ */
+/*              Local Type Definitions                          */
+/* ------------------------------------------------------------ */
+#define FIRST_PIN         2
+#define INPUT_COUNT       32
+#define UPDATE_COUNT      10000
+#define INTERVAL_MS       20
+/* ------------------------------------------------------------ */
+/*              Global Variables                                */
+/* ------------------------------------------------------------ */
+Bounce*      rgpdeb[INPUT_COUNT];
+BounceBank   bank(INTERVAL_MS);
+//reads of the clock by the debouncers
+uint32_t     cClockRead;
+//time given by SteppingClock
+unsigned long msStep;
+//keeps the results used so the updates are not optimized away
+uint32_t     cChange;
+/* ------------------------------------------------------------ */
+/*              Forward Declarations                            */
+/* ------------------------------------------------------------ */
+unsigned long CountingClock();
+unsigned long SteppingClock();
+void PrintResult(const char* szName, uint32_t us);
+
+
+void setup() {
+    uint32_t usStart;
+    Serial.begin(9600);
+    Bounce::setClock(CountingClock);
+    for (uint8_t i = 0; i < INPUT_COUNT; i++) {
+        pinMode(FIRST_PIN + i, INPUT);
+        rgpdeb[i] = new Bounce(FIRST_PIN + i, INTERVAL_MS);
+        bank.addPin(FIRST_PIN + i);
+    }
+    Serial.println("debouncer,inputs,us_per_update,us_per_input,clock_reads_per_input");
+    cClockRead = 0;
+    usStart = micros();
+    for (uint16_t n = 0; n < UPDATE_COUNT; n++) {
+        for (uint8_t i = 0; i < INPUT_COUNT; i++) {
+            cChange += rgpdeb[i]->update();
+        }
+    }
+    PrintResult("bounce", micros() - usStart);
+    cClockRead = 0;
+    usStart = micros();
+    for (uint16_t n = 0; n < UPDATE_COUNT; n++) {
+        Bounce::updateAll(rgpdeb, INPUT_COUNT);
+    }
+    PrintResult("bounce_update_all", micros() - usStart);
+    cClockRead = 0;
+    usStart = micros();
+    for (uint16_t n = 0; n < UPDATE_COUNT; n++) {
+        cChange += bank.update() != 0;
+    }
+    PrintResult("bounce_bank", micros() - usStart);
+    Bounce::setClock(SteppingClock);
+    msStep = millis();
+    cClockRead = 0;
+    usStart = micros();
+    for (uint16_t n = 0; n < UPDATE_COUNT; n++) {
+        cChange += bank.update() != 0;
+    }
+    PrintResult("bounce_bank_sample", micros() - usStart);
+    Bounce::setClock(millis);
+}
+
+void loop() {
+}
+/* ------------------------------------------------------------------- */
+/** unsigned long  CountingClock()
+**
+**	Description:
+**		The clock of the debouncers, millis counting its calls
+**
+-----------------------------------------------------------------------*/
+unsigned long CountingClock()
+{
+    cClockRead++;
+    return millis();
+}
+/* ------------------------------------------------------------------- */
+/** unsigned long  SteppingClock()
+**
+**	Description:
+**		The clock of the debouncers moving by one sample period of the bank
+**		at each call, so each update of the bank takes a sample
+**
+-----------------------------------------------------------------------*/
+unsigned long SteppingClock()
+{
+    cClockRead++;
+    msStep += INTERVAL_MS / BOUNCEBANK_SAMPLES;
+    return msStep;
+}
+/* ------------------------------------------------------------------- */
+/** void  PrintResult(const char* szName, uint32_t us)
+**
+**	Description:
+**		Prints the average times of one round of updates and of one input in
+**		us, and the clock reads for one input
+**
+-----------------------------------------------------------------------*/
+void PrintResult(const char* szName, uint32_t us)
+{
+    Serial.print(szName);
+    Serial.print(',');
+    Serial.print(INPUT_COUNT);
+    Serial.print(',');
+    Serial.print((double)us / UPDATE_COUNT, 2);
+    Serial.print(',');
+    Serial.print((double)us / UPDATE_COUNT / INPUT_COUNT, 3);
+    Serial.print(',');
+    Serial.println((double)cClockRead / UPDATE_COUNT / INPUT_COUNT, 3);
+}
@@ -59,13 +59,11 @@
 /*              Global Variables                                */
 /* ------------------------------------------------------------ */
 LCDS         MyLCDS;
-char         szInfo1[0x27]; 
-char         szInfo2[0x27];
-//custom characters definition
-byte         defChar[] = {0, 0x4, 0x2, 0x1F, 0x02, 0x4, 0, 0};
-byte         defChar1[] = {14, 31, 21, 31, 23, 16, 31, 14};
-byte         defChar2[] = {0x00, 0x1F, 0x11, 0x00, 0x00, 0x11, 0x1F, 0x00};
-byte         defChar3[] = {0x00, 0x0A, 0x15, 0x11, 0x0A, 0x04, 0x00, 0x00};
+//custom characters definition, loaded at positions 1 to 4
+byte         defChars[][8] = {{0, 0x4, 0x2, 0x1F, 0x02, 0x4, 0, 0},
+                              {14, 31, 21, 31, 23, 16, 31, 14},
+                              {0x00, 0x1F, 0x11, 0x00, 0x00, 0x11, 0x1F, 0x00},
+                              {0x00, 0x0A, 0x15, 0x11, 0x0A, 0x04, 0x00, 0x00}};
 //bytes array representing the position of the user defined characters in the memory
 byte         charsToDisp[] = {1, 2, 3, 4, 0};
 //definitions for display and cursor settings flags
@@ -99,25 +97,19 @@ void setup() {
     MyLCDS.DisplaySet(true, true);
     MyLCDS.DisplayMode(0);
     
-    // define custom characters for displaying on the LCD
-    MyLCDS.DefineUserChar(defChar, 1);
-    delay(5);
-    MyLCDS.DefineUserChar(defChar1, 2);
-    delay(5);
-    MyLCDS.DefineUserChar(defChar2, 3);
-    delay(5);
-    MyLCDS.DefineUserChar(defChar3, 4);
-    delay(5);
+    // define custom characters for displaying on the LCD, in one burst
+    // the library waits for the device only if a command needs the chars
+    MyLCDS.DefineUserChars(defChars[0], 1, 4);
 }
 
 void loop() {
  
   // 1. Welcome message displayed
     MyLCDS.DisplayClear(); // clear display, return cursor home
-    strcpy(szInfo1, "CLS Demo");
-    strcpy(szInfo2, "Press any button");
-    MyLCDS.WriteStringAtPos(0, 0, szInfo1);
-    MyLCDS.WriteStringAtPos(1, 0, szInfo2);
+    MyLCDS.SetPos(0, 0);
+    MyLCDS.print("CLS Demo");
+    MyLCDS.SetPos(1, 0);
+    MyLCDS.print("Press any button");
     fBtn1Process = false;
     fBtn2Process = false;
     //wait until any button pressed
@@ -128,10 +120,10 @@ void loop() {
    
    /*
     // 2. Toggle Backlight (not supported by pmodCLS)
-    strcpy(szInfo1, "BTN2: Backlight");
-    strcpy(szInfo2, "BTN1: Continue");
-    MyLCDS.WriteStringAtPos(0, 0, szInfo1);
-    MyLCDS.WriteStringAtPos(1, 0, szInfo2); 
+    MyLCDS.SetPos(0, 0);
+    MyLCDS.print("BTN2: Backlight");
+    MyLCDS.SetPos(1, 0);
+    MyLCDS.print("BTN1: Continue");
     fBtn1Process = false;
     fBtn2Process = false;
     //wait for button 1 pressed to continue
@@ -154,10 +146,10 @@ void loop() {
     MyLCDS.DisplaySet(true, true);
     // clear display, return cursor home
     MyLCDS.DisplayClear(); 
-    strcpy(szInfo1, "Btns - L/R scroll long text");
-    strcpy(szInfo2, "BTN1&BTN2: continue");
-    MyLCDS.WriteStringAtPos(0, 0, szInfo1);
-    MyLCDS.WriteStringAtPos(1, 0, szInfo2); 
+    MyLCDS.SetPos(0, 0);
+    MyLCDS.print("Btns - L/R scroll long text");
+    MyLCDS.SetPos(1, 0);
+    MyLCDS.print("BTN1&BTN2: continue");
     while(fBtn1Process == false || fBtn2Process == false) {
 	WaitUntilBtnPressed(&fBtn1Process, &fBtn2Process);
 	if(fBtn1Process != fBtn2Process) {
@@ -169,10 +161,10 @@ void loop() {
     MyLCDS.DisplayClear(); // clear display, return cursor home
 
     // 4. Toggle cursor 
-    strcpy(szInfo1, "BTN2: Cursor");
-    strcpy(szInfo2, "BTN1: Continue");
-    MyLCDS.WriteStringAtPos(0, 0, szInfo1);
-    MyLCDS.WriteStringAtPos(1, 0, szInfo2); 
+    MyLCDS.SetPos(0, 0);
+    MyLCDS.print("BTN2: Cursor");
+    MyLCDS.SetPos(1, 0);
+    MyLCDS.print("BTN1: Continue");
     fBtn1Process = false;
     fBtn2Process = false;
 	//wait for button 1 pressed to continue
@@ -186,10 +178,10 @@ void loop() {
     }
   
     // 5. Toggle blink
-    strcpy(szInfo1, "BTN2: Blink ");
-    strcpy(szInfo2, "BTN1: Continue");
-    MyLCDS.WriteStringAtPos(0, 0, szInfo1);
-    MyLCDS.WriteStringAtPos(1, 0, szInfo2); 
+    MyLCDS.SetPos(0, 0);
+    MyLCDS.print("BTN2: Blink ");
+    MyLCDS.SetPos(1, 0);
+    MyLCDS.print("BTN1: Continue");
     fBtn1Process = false;
     fBtn2Process = false;
 	//wait for button 1 pressed to continue
@@ -204,10 +196,10 @@ void loop() {
     MyLCDS.CursorModeSet(true, false);
     
     // 6. Erase chars
-    strcpy(szInfo1, "BTN2: Erase char");
-    strcpy(szInfo2, "BTN1: Continue");
-    MyLCDS.WriteStringAtPos(0, 0, szInfo1);
-    MyLCDS.WriteStringAtPos(1, 0, szInfo2); 
+    MyLCDS.SetPos(0, 0);
+    MyLCDS.print("BTN2: Erase char");
+    MyLCDS.SetPos(1, 0);
+    MyLCDS.print("BTN1: Continue");
     fBtn1Process = false;
     fBtn2Process = false;
     MyLCDS.SetPos(0, 10);
@@ -223,10 +215,10 @@ void loop() {
     MyLCDS.DisplayClear(); // clear display, return cursor home
     
     // 7. Erase in line
-    strcpy(szInfo1, "BTN2: Erase");
-    strcpy(szInfo2, "BTN1: Continue");
-    MyLCDS.WriteStringAtPos(0, 0, szInfo1);
-    MyLCDS.WriteStringAtPos(1, 0, szInfo2); 
+    MyLCDS.SetPos(0, 0);
+    MyLCDS.print("BTN2: Erase");
+    MyLCDS.SetPos(1, 0);
+    MyLCDS.print("BTN1: Continue");
     fBtn1Process = false;
     fBtn2Process = false;
     MyLCDS.SetPos(0, 6);
@@ -243,12 +235,12 @@ void loop() {
     // 8. User char.
     // define characters in RAM at positions 0, 1, 2, 3 
     MyLCDS.DisplayClear(); // clear display, return cursor home
-    strcpy(szInfo1, "User char:");
-    MyLCDS.WriteStringAtPos(0, 0, szInfo1);
+    MyLCDS.SetPos(0, 0);
+    MyLCDS.print("User char:");
     // write user defined character	
     MyLCDS.DispUserChar(charsToDisp, 4, 0, 10);
-    strcpy(szInfo2, "Btn to continue");
-    MyLCDS.WriteStringAtPos(1, 0, szInfo2);
+    MyLCDS.SetPos(1, 0);
+    MyLCDS.print("Btn to continue");
     fBtn1Process = false;
     fBtn2Process = false;
     //move forward if any button pressed
@@ -0,0 +1,135 @@
+/************************************************************************/
+/*                                                                      */
+/*  KeypadDemo                                                          */
+/*                                                                      */
+/************************************************************************/
+/*  Module Description:                                                 */
+/*                                                                      */
+/* This sketch reads a 4x4 keypad, like the PmodKYPD, with a            */
+/* BounceMatrix and shows on the PmodCLS the keys typed and the keys    */
+/* held.                                                                */
+/*                                                                      */
+/*  Functionality:                                                      */
+/*                                                                      */
+/* The keypad is scanned every SCAN_MS ms and each key is debounced     */
+/* over INTERVAL_MS ms. The first line of the display shows the last    */
+/* 16 keys typed, the second one the number of keys held, or "ghost"   */
+/* when 3 keys held hide a 4th one. Once a second the sketch prints a   */
+/* CSV line with the scans done in the last second, the time of the     */
+/* last scan and of the longest one in us, and the share of the time    */
+/* taken by the scans in 1/1000.                                        */
+/*                                                                      */
+/*  Required Hardware:                                                  */
+/*      1. chipKIT Uno32 or any other board with 8 free digital pins    */
+/*      2. PmodKYPD, its column pins on rowPins and its row pins on     */
+/*         colPins                                                      */
+/*      3. PmodCLS                                                      */
+/*                                                                      */
+/************************************************************************/
+/*  Revision History:                                                   */
+/*                                                                      */
+/*  10/17/2026: created                                                 */
+/*                                                                      */
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*              Include File Definitions                        */
+/* ------------------------------------------------------------ */
+#include <LCDS.h>
+#include <DSPI.h>
+#include <Wire.h>
+#include <Bounce.h>
+#include <BounceMatrix.h>
+/* ------------------------------------------------------------ */
+/*              Local Type Definitions                          */
+/* ------------------------------------------------------------ */
+#define INTERVAL_MS       20
+#define SCAN_MS           2
+#define REPORT_MS         1000
+/* ------------------------------------------------------------ */
+/*              Global Variables                                */
+/* ------------------------------------------------------------ */
+LCDS         MyLCDS;
+BounceMatrix keypad(INTERVAL_MS, SCAN_MS);
+//pins driven low one at a time, and pins read
+const uint8_t rowPins[4] = {26, 27, 28, 29};
+const uint8_t colPins[4] = {30, 31, 32, 33};
+//label of each key, one PmodKYPD column after the other
+const char   szKeys[]     = "1470258F369EABCD";
+//last keys typed, shown on the first line
+char         szTyped[17]  = "                ";
+unsigned long msReport;
+/* ------------------------------------------------------------ */
+/*              Forward Declarations                            */
+/* ------------------------------------------------------------ */
+//function that shows the keys held on the second line
+void ShowHeld();
+
+
+void setup() {
+    Serial.begin(9600);
+    //select communication protocol
+    //MyLCDS.Begin(PAR_ACCESS_DSPI0);//SPI
+    //MyLCDS.Begin(PAR_ACCESS_UART2);//UART
+    MyLCDS.Begin(PAR_ACCESS_I2C);//I2C
+    MyLCDS.DisplaySet(true, true);
+    MyLCDS.DisplayMode(0);
+    MyLCDS.DisplayClear();
+    MyLCDS.SetPos(0, 0);
+    MyLCDS.print("Type on keypad");
+    keypad.begin(rowPins, 4, colPins, 4);
+    Serial.println("scans_per_s,scan_us,scan_us_max,load_permille");
+    msReport = millis();
+}
+
+void loop() {
+    int idxKey;
+    if (keypad.update() > 0) {
+        idxKey = keypad.risingKey();
+        if (idxKey >= 0) {
+            //shift the keys typed left and add the new one
+            memmove(szTyped, szTyped + 1, 15);
+            szTyped[15] = szKeys[idxKey];
+            MyLCDS.WriteStringAtPos(0, 0, szTyped);
+        }
+        ShowHeld();
+    }
+    if (millis() - msReport >= REPORT_MS) {
+        msReport = millis();
+        Serial.print(keypad.scanRate());
+        Serial.print(",");
+        Serial.print(keypad.scanMicros());
+        Serial.print(",");
+        Serial.print(keypad.scanMicrosMax());
+        Serial.print(",");
+        Serial.println(keypad.loadPermille());
+    }
+}
+/* ------------------------------------------------------------------- */
+/** void  ShowHeld()
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function writes on the second line the number of keys held,
+**		or "ghost" when some keys can not be told apart
+**
+-----------------------------------------------------------------------*/
+void ShowHeld()
+{
+    char szLine[17];
+    if (keypad.ghosting()) {
+        strcpy(szLine, "ghost           ");
+    }
+    else {
+        sprintf(szLine, "held: %-10u", keypad.pressedCount());
+    }
+    MyLCDS.WriteStringAtPos(1, 0, szLine);
+}
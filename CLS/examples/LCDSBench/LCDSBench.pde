@@ -0,0 +1,539 @@
+/************************************************************************/
+/*                                                                      */
+/*  LCDSBench                                                           */
+/*                                                                      */
+/************************************************************************/
+/*  Module Description:                                                 */
+/*                                                                      */
+/* This sketch measures the traffic produced by the LCDS library for a  */
+/* set of typical display workloads. The library sends to the LCDSEmu   */
+/* emulator through PAR_ACCESS_USER, so no PmodCLS is needed and the    */
+/* results are repeatable.                                              */
+/*                                                                      */
+/*  Functionality:                                                      */
+/*                                                                      */
+/* Each workload is run once. The sketch prints one CSV line for each,  */
+/* with the bytes and transactions sent and the time they take on the   */
+/* bus at the speeds supported by the PmodCLS. The times only model the */
+/* bus: 8 bits a byte on SPI, 10 bits a byte on UART (8N1), 9 bits a    */
+/* byte plus start, address and stop on I2C, in frames of up to 32      */
+/* bytes. The last column counts the commands the emulator rejected    */
+/* but for the ones the commands workload sends on purpose, and the     */
+/* screens that did not show what was wanted, it has to be 0.           */
+/* A second table times the full_refresh workload sent on the DSPI0     */
+/* port with the SPI transfer modes of SetSPIBurst, giving the bytes a  */
+/* second the board really reaches. The display does not have to be     */
+/* connected for it.                                                    */
+/*                                                                      */
+/*  Required Hardware:                                                  */
+/*      1. any chipKIT board, the results are printed on Serial         */
+/*                                                                      */
+/************************************************************************/
+/*  Revision History:                                                   */
+/*                                                                      */
+/*  10/17/2026: created                                                 */
+/*                                                                      */
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*              Include File Definitions                        */
+/* ------------------------------------------------------------ */
+#include <LCDS.h>
+#include <LCDSEmu.h>
+#include <DSPI.h>
+#include <Wire.h>
+/* ------------------------------------------------------------ */
+/*              Local Type Definitions                          */
+/* ------------------------------------------------------------ */
+//bus speeds of the model
+#define SPI_HZ            625000
+#define I2C_FRAME_MAX     32
+//bits sent for each I2C frame besides the data: start, address with ack, stop
+#define I2C_FRAME_BITS    11
+/* ------------------------------------------------------------ */
+/*              Global Variables                                */
+/* ------------------------------------------------------------ */
+LCDS         MyLCDS;
+LCDSEmu      MyEmu;
+//bits put on each bus by the current workload
+uint32_t     cbitSpi;
+uint32_t     cbitI2C;
+uint32_t     cbitUart;
+uint32_t     cI2CFrame;
+//screens checked by the workloads that differ from what was wanted
+uint32_t     cMismatch;
+//errors of the emulator caused on purpose by a workload
+uint32_t     cErrExpected;
+const uint32_t rgI2CHz[]  = {100000, 400000};
+const uint32_t rgUartBd[] = {9600, 19200, 38400, 57600, 76800};
+//user defined characters of the CLSDemo sequence
+byte         defChars[][8] = {{0, 0x4, 0x2, 0x1F, 0x02, 0x4, 0, 0},
+                              {14, 31, 21, 31, 23, 16, 31, 14},
+                              {0x00, 0x1F, 0x11, 0x00, 0x00, 0x11, 0x1F, 0x00},
+                              {0x00, 0x0A, 0x15, 0x11, 0x0A, 0x04, 0x00, 0x00}};
+byte         charsToDisp[] = {1, 2, 3, 4};
+/* ------------------------------------------------------------ */
+/*              Forward Declarations                            */
+/* ------------------------------------------------------------ */
+void BenchSend(void* pvCtx, const uint8_t* rgbSnd, uint8_t cbSnd);
+void RunWorkload(const char* szName, void (*pfnWorkload)());
+void RunSpi(const char* szName, boolean fBurst, uint8_t usByteGap);
+void PrintTime(uint32_t cbit, uint32_t hz);
+void WkFullRefresh();
+void WkCounterTick();
+void WkCounterPrint();
+void WkTicker();
+void WkTickerScroll();
+void WkMenu();
+void WkDemo();
+void WkUpdate();
+void WkCommands();
+void CheckRow(uint8_t idxRow, const char* szRow);
+void CheckVisible(uint8_t idxRow, const char* szRow);
+void Check(boolean fOk);
+
+
+void setup() {
+    Serial.begin(9600);
+    Serial.println("workload,bytes,transactions,i2c_frames,spi_625k_us,i2c_100k_us,i2c_400k_us,"
+                   "uart_9600_us,uart_19200_us,uart_38400_us,uart_57600_us,uart_76800_us,errors");
+    RunWorkload("full_refresh", WkFullRefresh);
+    RunWorkload("counter_tick", WkCounterTick);
+    RunWorkload("counter_print", WkCounterPrint);
+    RunWorkload("ticker", WkTicker);
+    RunWorkload("ticker_scroll", WkTickerScroll);
+    RunWorkload("menu", WkMenu);
+    RunWorkload("clsdemo", WkDemo);
+    RunWorkload("update_rows", WkUpdate);
+    RunWorkload("commands", WkCommands);
+    Serial.println("spi_mode,bytes,transactions,us,bytes_per_s");
+    RunSpi("byte_loop", false, 0);
+    RunSpi("burst", true, 0);
+    RunSpi("byte_gap_2us", true, 2);
+}
+
+void loop() {
+}
+/* ------------------------------------------------------------------- */
+/** void  BenchSend(void* pvCtx, const uint8_t* rgbSnd, uint8_t cbSnd)
+**
+**	Parameters:
+**		pvCtx - the emulator
+**		rgbSnd - the bytes of one transaction
+**		cbSnd - the number of bytes
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function adds the bits of a transaction to the bus models and
+**		passes it to the emulator
+**
+-----------------------------------------------------------------------*/
+void BenchSend(void* pvCtx, const uint8_t* rgbSnd, uint8_t cbSnd)
+{
+    uint32_t cFrame = (cbSnd + I2C_FRAME_MAX - 1) / I2C_FRAME_MAX;
+    cbitSpi += 8 * (uint32_t)cbSnd;
+    cbitUart += 10 * (uint32_t)cbSnd;
+    cbitI2C += 9 * (uint32_t)cbSnd + I2C_FRAME_BITS * cFrame;
+    cI2CFrame += cFrame;
+    LCDSEmu::Send(pvCtx, rgbSnd, cbSnd);
+}
+/* ------------------------------------------------------------------- */
+/** void  RunWorkload(const char* szName, void (*pfnWorkload)())
+**
+**	Parameters:
+**		szName - the name printed in the first column
+**		pfnWorkload - the function calling the library
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		This function starts a workload with a power-on display and a library
+**		that knows nothing about it, then prints its CSV line
+**
+-----------------------------------------------------------------------*/
+void RunWorkload(const char* szName, void (*pfnWorkload)())
+{
+    MyEmu.Reset();
+    MyEmu.ResetCounters();
+    MyLCDS.Begin(BenchSend, &MyEmu);
+    cbitSpi = 0;
+    cbitI2C = 0;
+    cbitUart = 0;
+    cI2CFrame = 0;
+    cMismatch = 0;
+    cErrExpected = 0;
+    pfnWorkload();
+    Serial.print(szName);
+    Serial.print(',');
+    Serial.print(MyEmu.Bytes());
+    Serial.print(',');
+    Serial.print(MyEmu.Transactions());
+    Serial.print(',');
+    Serial.print(cI2CFrame);
+    PrintTime(cbitSpi, SPI_HZ);
+    for (uint8_t i = 0; i < sizeof(rgI2CHz) / sizeof(rgI2CHz[0]); i++) {
+        PrintTime(cbitI2C, rgI2CHz[i]);
+    }
+    for (uint8_t i = 0; i < sizeof(rgUartBd) / sizeof(rgUartBd[0]); i++) {
+        PrintTime(cbitUart, rgUartBd[i]);
+    }
+    Serial.print(',');
+    Serial.println(MyEmu.Errors() - cErrExpected + cMismatch);
+}
+/* ------------------------------------------------------------------- */
+/** void  RunSpi(const char* szName, boolean fBurst, uint8_t usByteGap)
+**
+**	Parameters:
+**		szName - the name printed in the first column
+**		fBurst, usByteGap - the parameters of SetSPIBurst
+**
+**	Description:
+**		Counts the bytes of the full_refresh workload on the emulator, then times
+**		the same workload sent on DSPI0 and prints the bytes a second
+**
+-----------------------------------------------------------------------*/
+void RunSpi(const char* szName, boolean fBurst, uint8_t usByteGap)
+{
+    uint32_t usSpi;
+    MyEmu.Reset();
+    MyEmu.ResetCounters();
+    MyLCDS.Begin(BenchSend, &MyEmu);
+    WkFullRefresh();
+    MyLCDS.Begin(PAR_ACCESS_DSPI0);
+    MyLCDS.SetSPIBurst(fBurst, usByteGap);
+    usSpi = micros();
+    WkFullRefresh();
+    usSpi = micros() - usSpi;
+    Serial.print(szName);
+    Serial.print(',');
+    Serial.print(MyEmu.Bytes());
+    Serial.print(',');
+    Serial.print(MyEmu.Transactions());
+    Serial.print(',');
+    Serial.print(usSpi);
+    Serial.print(',');
+    Serial.println((uint32_t)(((uint64_t)MyEmu.Bytes() * 1000000) / (usSpi > 0 ? usSpi : 1)));
+}
+/* ------------------------------------------------------------------- */
+/** void  PrintTime(uint32_t cbit, uint32_t hz)
+**
+**	Description:
+**		Prints a column with the time in us taken by cbit bits at hz bits per second
+**
+-----------------------------------------------------------------------*/
+void PrintTime(uint32_t cbit, uint32_t hz)
+{
+    Serial.print(',');
+    Serial.print((uint32_t)(((uint64_t)cbit * 1000000 + hz / 2) / hz));
+}
+/* ------------------------------------------------------------------- */
+/** Workloads
+**
+**	Description:
+**		WkFullRefresh - redraws both visible rows with new text, 20 times
+**		WkCounterTick - a counter shown right aligned, incremented 100 times
+**		WkCounterPrint - the same counter drawn with print and WriteNumberAtPos, with
+**				a fixed point value below it, checked against the emulator
+**		WkTicker - a 40 chars message scrolled through the 16 columns of a row
+**		WkTickerScroll - the same frames drawn with UpdateVisible, which scrolls
+**				the display, each one checked against the emulator
+**		WkMenu - a 4 items menu, the selection moved down and up 3 times
+**		WkDemo - the library calls of CLSDemo.pde, one button press for each step
+**		WkUpdate - status screens drawn with UpdateDisplay and UpdateRow, each one
+**				checked against the emulator
+**		WkCommands - every command of the library once, with the state of the
+**				emulator checked after them
+**
+-----------------------------------------------------------------------*/
+void WkFullRefresh()
+{
+    char szRow[17];
+    MyLCDS.DisplayClear();
+    for (uint8_t i = 0; i < 20; i++) {
+        for (uint8_t idxRow = 0; idxRow < 2; idxRow++) {
+            for (uint8_t idxCol = 0; idxCol < 16; idxCol++) {
+                szRow[idxCol] = 'A' + (i + idxRow + idxCol) % 26;
+            }
+            szRow[16] = 0;
+            MyLCDS.WriteStringAtPos(idxRow, 0, szRow);
+        }
+    }
+}
+
+void WkCounterTick()
+{
+    char szCount[6];
+    MyLCDS.DisplayClear();
+    MyLCDS.WriteStringAtPos(0, 0, (char*)"Count:");
+    for (uint16_t i = 0; i < 100; i++) {
+        uint16_t n = i;
+        for (int8_t idx = 4; idx >= 0; idx--) {
+            szCount[idx] = (idx == 4 || n != 0) ? '0' + n % 10 : ' ';
+            n /= 10;
+        }
+        szCount[5] = 0;
+        MyLCDS.WriteStringAtPos(0, 11, szCount);
+    }
+}
+
+void WkCounterPrint()
+{
+    MyLCDS.DisplayClear();
+    MyLCDS.print("Count:");
+    MyLCDS.SetPos(1, 0);
+    MyLCDS.print("Temp");
+    for (uint16_t i = 0; i < 100; i++) {
+        MyLCDS.WriteNumberAtPos(0, 11, i, 5);
+        MyLCDS.WriteNumberAtPos(1, 10, 250 - 3 * (int16_t)i, 6, 1);
+    }
+    CheckRow(0, "Count:        99");
+    CheckRow(1, "Temp        -4.7");
+}
+
+void WkTicker()
+{
+    const char* szMsg = "PmodCLS ticker: 1234.5 up 0.7% ** news ";
+    char szRow[17];
+    MyLCDS.DisplayClear();
+    for (uint8_t i = 0; i < 40; i++) {
+        for (uint8_t idxCol = 0; idxCol < 16; idxCol++) {
+            szRow[idxCol] = szMsg[(i + idxCol) % 40];
+        }
+        szRow[16] = 0;
+        MyLCDS.WriteStringAtPos(1, 0, szRow);
+    }
+}
+
+void WkTickerScroll()
+{
+    const char* szMsg = "PmodCLS ticker: 1234.5 up 0.7% ** news ";
+    char szRow[17];
+    MyLCDS.DisplayClear();
+    for (uint8_t i = 0; i < 40; i++) {
+        for (uint8_t idxCol = 0; idxCol < 16; idxCol++) {
+            szRow[idxCol] = szMsg[(i + idxCol) % 40];
+        }
+        szRow[16] = 0;
+        MyLCDS.UpdateVisible(NULL, szRow);
+        CheckVisible(0, "");
+        CheckVisible(1, szRow);
+    }
+}
+
+void WkMenu()
+{
+    const char* rgszItem[] = {"Settings", "Display", "Network", "About"};
+    char szRow[17];
+    uint8_t idxSel = 0;
+    MyLCDS.DisplayClear();
+    for (uint8_t i = 0; i < 18; i++) {
+        //the selected item is on the first row, the next one below it
+        for (uint8_t idxRow = 0; idxRow < 2; idxRow++) {
+            szRow[0] = (idxRow == 0) ? '>' : ' ';
+            szRow[1] = ' ';
+            strcpy(szRow + 2, rgszItem[(idxSel + idxRow) % 4]);
+            for (uint8_t idxCol = strlen(szRow); idxCol < 16; idxCol++) {
+                szRow[idxCol] = ' ';
+            }
+            szRow[16] = 0;
+            MyLCDS.WriteStringAtPos(idxRow, 0, szRow);
+        }
+        idxSel = ((i / 3) % 2 == 0) ? (idxSel + 1) % 4 : (idxSel + 3) % 4;
+    }
+}
+
+void WkDemo()
+{
+    MyLCDS.DisplaySet(true, true);
+    MyLCDS.DisplayMode(0);
+    MyLCDS.DefineUserChars(defChars[0], 1, 4);
+    //1. welcome message
+    MyLCDS.DisplayClear();
+    MyLCDS.WriteStringAtPos(0, 0, (char*)"CLS Demo");
+    MyLCDS.WriteStringAtPos(1, 0, (char*)"Press any button");
+    MyLCDS.DisplayClear();
+    //3. scroll
+    MyLCDS.DisplayMode(0);
+    MyLCDS.DisplaySet(true, true);
+    MyLCDS.DisplayClear();
+    MyLCDS.WriteStringAtPos(0, 0, (char*)"Btns - L/R scroll long text");
+    MyLCDS.WriteStringAtPos(1, 0, (char*)"BTN1&BTN2: continue");
+    MyLCDS.DisplayScroll(true, 1);
+    MyLCDS.DisplayScroll(false, 1);
+    MyLCDS.DisplayClear();
+    //4. cursor
+    MyLCDS.WriteStringAtPos(0, 0, (char*)"BTN2: Cursor");
+    MyLCDS.WriteStringAtPos(1, 0, (char*)"BTN1: Continue");
+    MyLCDS.CursorModeSet(true, false);
+    //5. blink
+    MyLCDS.WriteStringAtPos(0, 0, (char*)"BTN2: Blink ");
+    MyLCDS.WriteStringAtPos(1, 0, (char*)"BTN1: Continue");
+    MyLCDS.CursorModeSet(true, true);
+    MyLCDS.CursorModeSet(true, false);
+    //6. erase chars
+    MyLCDS.WriteStringAtPos(0, 0, (char*)"BTN2: Erase char");
+    MyLCDS.WriteStringAtPos(1, 0, (char*)"BTN1: Continue");
+    MyLCDS.SetPos(0, 10);
+    MyLCDS.EraseChars(4);
+    MyLCDS.DisplayClear();
+    //7. erase in line
+    MyLCDS.WriteStringAtPos(0, 0, (char*)"BTN2: Erase");
+    MyLCDS.WriteStringAtPos(1, 0, (char*)"BTN1: Continue");
+    MyLCDS.SetPos(0, 6);
+    MyLCDS.EraseInLine(0);
+    //8. user chars
+    MyLCDS.DisplayClear();
+    MyLCDS.WriteStringAtPos(0, 0, (char*)"User char:");
+    MyLCDS.DispUserChar(charsToDisp, 4, 0, 10);
+    MyLCDS.WriteStringAtPos(1, 0, (char*)"Btn to continue");
+}
+
+void WkUpdate()
+{
+    const char* rgszScreen[][2] = {
+        {"Temp  21.5 C", "Fan   auto"},
+        {"Temp  21.6 C", "Fan   auto"},
+        {"Temp  21.6 C", "Fan   high  [!]"},
+        {"", "Saving..."},
+        {"Saved", ""},
+        {"A   B   C   D", "1   2   3   4"},
+        {"A       C", "1           4"},
+        {"Long text that fills the hidden columns", ""},
+        {"Short", "Long text that fills the hidden columns"},
+        {"Temp  21.5 C", "Fan   auto"}};
+    MyLCDS.DisplayMode(false);
+    for (uint8_t i = 0; i < sizeof(rgszScreen) / sizeof(rgszScreen[0]); i++) {
+        if (i % 2 == 0) {
+            MyLCDS.UpdateDisplay(rgszScreen[i][0], rgszScreen[i][1]);
+        }
+        else {
+            MyLCDS.UpdateRow(0, rgszScreen[i][0]);
+            MyLCDS.UpdateRow(1, rgszScreen[i][1]);
+        }
+        CheckRow(0, rgszScreen[i][0]);
+        CheckRow(1, rgszScreen[i][1]);
+    }
+}
+void WkCommands()
+{
+    uint8_t rgbGlyph[2][8] = {{0x1F, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x1F},
+                              {0x04, 0x0E, 0x1F, 0x04, 0x04, 0x04, 0x04, 0x00}};
+    //user char 0 is sent as a 0 byte
+    uint8_t rgbChar[] = {0, 1};
+    MyLCDS.DisplaySet(true, false);
+    Check(MyEmu.DisplayOn() && !MyEmu.BacklightOn());
+    MyLCDS.DisplaySet(true, true);
+    MyLCDS.CursorModeSet(true, true);
+    Check(MyEmu.CursorMode() == 2);
+    MyLCDS.CursorModeSet(false, false);
+    MyLCDS.DisplayMode(false);
+    Check(MyEmu.WrapCols() == 40);
+    MyLCDS.DisplayClear();
+    MyLCDS.WriteStringAtPos(0, 0, (char*)"Commands: 0123456789");
+    MyLCDS.SetPos(0, 10);
+    MyLCDS.SaveCursor();
+    MyLCDS.SetPos(1, 0);
+    MyLCDS.RestoreCursor();
+    MyLCDS.EraseChars(2);
+    MyLCDS.SetPos(0, 16);
+    MyLCDS.EraseInLine(0);
+    CheckRow(0, "Commands:   2345");
+    MyLCDS.DefineUserChars(rgbGlyph[0], 0, 2);
+    MyLCDS.DispUserChar(rgbChar, 2, 1, 0);
+    Check(MyEmu.CharAt(1, 0) == 0 && MyEmu.CharAt(1, 1) == 1);
+    Check(memcmp(MyEmu.Glyph(0), rgbGlyph[0], 8) == 0 && memcmp(MyEmu.Glyph(1), rgbGlyph[1], 8) == 0);
+    MyLCDS.DisplayScroll(false, 12);
+    Check(MyEmu.ScrollOffset() == 12);
+    MyLCDS.DisplayScroll(true, 12);
+    Check(MyEmu.ScrollOffset() == 0 && MyEmu.WrapCols() == 16);
+    MyLCDS.EepromWrEn();
+    MyLCDS.SaveRamtoEeprom(0);
+    MyLCDS.LdEepromToRam(0);
+    MyLCDS.CharsToLcd(0);
+    Check(MyEmu.ActiveTable() == 0);
+    MyLCDS.EepromWrEn();
+    MyLCDS.SaveBR(4);
+    Check(MyEmu.EepromBaud() == 4);
+    MyLCDS.EepromWrEn();
+    MyLCDS.SaveCommToEeprom(3);
+    Check(MyEmu.EepromComm() == 3);
+    MyLCDS.EepromWrEn();
+    MyLCDS.SaveTWIAddr(0x4C);
+    Check(MyEmu.EepromTWIAddr() == 0x4C);
+    MyLCDS.EepromWrEn();
+    MyLCDS.SaveCursorToEeprom(1);
+    MyLCDS.EepromWrEn();
+    MyLCDS.SaveDisplayToEeprom(3);
+    Check(MyEmu.EepromWrites() == 6);
+    //a save without write enable is rejected and leaves the EEPROM alone
+    cErrExpected = MyEmu.Errors() + 1;
+    MyLCDS.SaveBR(5);
+    Check(MyEmu.EepromBaud() == 4 && MyEmu.EepromWrites() == 6 && MyEmu.Errors() == cErrExpected);
+    //a baud rate change is written once, and not at all when the display has it
+    Check(MyLCDS.NegotiateSpeed(19200, 9600) == LCDS_ERR_NOT_CHECKED);
+    Check(MyEmu.EepromBaud() == 3 && MyEmu.EepromComm() == 3 && MyEmu.EepromWrites() == 8);
+    Check(MyLCDS.NegotiateSpeed(19200, 19200) == LCDS_ERR_SUCCESS && MyEmu.EepromWrites() == 8);
+    Check(MyLCDS.GetSpeed() == 19200);
+    MyLCDS.Reset();
+    Check(MyEmu.WrapCols() == 16 && MyEmu.CharAt(0, 0) == ' ');
+}
+/* ------------------------------------------------------------------- */
+/** void  CheckRow(uint8_t idxRow, const char* szRow)
+**
+**	Description:
+**		Counts a mismatch when the 40 columns of a row in the emulator are not
+**		the text followed by blanks
+**
+-----------------------------------------------------------------------*/
+void CheckRow(uint8_t idxRow, const char* szRow)
+{
+    uint8_t cch = strlen(szRow);
+    for (uint8_t idxCol = 0; idxCol < LCDSEMU_COLS; idxCol++) {
+        if (MyEmu.CharAt(idxRow, idxCol) != ((idxCol < cch) ? szRow[idxCol] : ' ')) {
+            cMismatch++;
+            return;
+        }
+    }
+}
+/* ------------------------------------------------------------------- */
+/** void  CheckVisible(uint8_t idxRow, const char* szRow)
+**
+**	Description:
+**		Counts a mismatch when the 16 columns of a row shown by the emulator are
+**		not the text followed by blanks
+**
+-----------------------------------------------------------------------*/
+void CheckVisible(uint8_t idxRow, const char* szRow)
+{
+    char szVis[LCDSEMU_VISIBLE_COLS + 1];
+    uint8_t cch = strlen(szRow);
+    MyEmu.GetVisibleRow(idxRow, szVis);
+    for (uint8_t idxCol = 0; idxCol < LCDSEMU_VISIBLE_COLS; idxCol++) {
+        if (szVis[idxCol] != ((idxCol < cch) ? szRow[idxCol] : ' ')) {
+            cMismatch++;
+            return;
+        }
+    }
+}
+/* ------------------------------------------------------------------- */
+/** void  Check(boolean fOk)
+**
+**	Description:
+**		Counts a mismatch when a check of the emulator state fails
+**
+-----------------------------------------------------------------------*/
+void Check(boolean fOk)
+{
+    if (!fOk) {
+        cMismatch++;
+    }
+}
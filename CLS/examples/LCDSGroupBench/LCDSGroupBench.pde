@@ -0,0 +1,261 @@
+/************************************************************************/
+/*                                                                      */
+/*  LCDSGroupBench                                                      */
+/*                                                                      */
+/************************************************************************/
+/*  Module Description:                                                 */
+/*                                                                      */
+/* This sketch measures how LCDSGroup shares one I2C bus between 6      */
+/* displays. Each display sends to its own LCDSEmu emulator through     */
+/* PAR_ACCESS_USER, and all of them share the same bus model, which     */
+/* waits for the time the bits take at 400 kHz, so no PmodCLS is needed */
+/* and the bus traffic and the settle time of the slow commands are     */
+/* measured on the same clock.                                          */
+/*                                                                      */
+/*  Functionality:                                                      */
+/*                                                                      */
+/* Display 0 is the slow one: each frame it redefines a user char, so   */
+/* its rows wait LCDS_SETTLE_DEF_CHAR_US for the device, then redraws   */
+/* both rows. Displays 1 to 5 show a counter. The frames are sent once  */
+/* draining the displays one after the other, then through LCDSGroup.   */
+/* In the _late runs the counters change only once the slow display is  */
+/* busy, so their traffic can use the bus while the slow display waits. */
+/* The sketch prints one CSV line for each run: the bytes and bus time  */
+/* at 400 kHz for all the frames, the average time from when the frame  */
+/* of a counter display, and of the slow display, is queued until its   */
+/* queue is empty, and the bus time the counters used while the slow    */
+/* display was busy. The last column counts the screens that did not    */
+/* show what was wanted.                                                */
+/*                                                                      */
+/*  Required Hardware:                                                  */
+/*      1. any chipKIT board, the results are printed on Serial         */
+/*                                                                      */
+/************************************************************************/
+/*  Revision History:                                                   */
+/*                                                                      */
+/*  10/17/2026: created                                                 */
+/*                                                                      */
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*              Include File Definitions                        */
+/* ------------------------------------------------------------ */
+#include <LCDS.h>
+#include <LCDSEmu.h>
+#include <LCDSGroup.h>
+#include <DSPI.h>
+#include <Wire.h>
+/* ------------------------------------------------------------ */
+/*              Local Type Definitions                          */
+/* ------------------------------------------------------------ */
+#define DISP_COUNT        6
+#define FRAME_COUNT       20
+#define I2C_HZ            400000
+#define I2C_FRAME_MAX     32
+//bits sent for each I2C frame besides the data: start, address with ack, stop
+#define I2C_FRAME_BITS    11
+/* ------------------------------------------------------------ */
+/*              Global Variables                                */
+/* ------------------------------------------------------------ */
+LCDS         rglcds[DISP_COUNT];
+LCDSEmu      rgemu[DISP_COUNT];
+//bits put on the shared bus
+uint32_t     cbitBus;
+uint32_t     cbBus;
+//bits sent to the counter displays while the slow one was busy
+uint32_t     cbitOverlap;
+//screens that differ from what was wanted
+uint32_t     cMismatch;
+byte         rgbGlyph[8] = {0x04, 0x0E, 0x1F, 0x04, 0x04, 0x04, 0x04, 0x00};
+/* ------------------------------------------------------------ */
+/*              Forward Declarations                            */
+/* ------------------------------------------------------------ */
+void BusSend(void* pvCtx, const uint8_t* rgbSnd, uint8_t cbSnd);
+void RunFrames(const char* szMode, boolean fGroup, boolean fLate);
+void QueueSlow(uint8_t idxFrame);
+void QueueCounters(uint8_t idxFrame);
+void CheckFrame(uint8_t idxFrame);
+uint32_t BusUs(uint32_t cbit);
+
+
+void setup() {
+    Serial.begin(9600);
+    Serial.println("mode,bytes,i2c_400k_us,counter_latency_us,slow_latency_us,overlap_us,errors");
+    RunFrames("one_by_one", false, false);
+    RunFrames("group", true, false);
+    RunFrames("one_by_one_late", false, true);
+    RunFrames("group_late", true, true);
+}
+
+void loop() {
+}
+/* ------------------------------------------------------------------- */
+/** void  BusSend(void* pvCtx, const uint8_t* rgbSnd, uint8_t cbSnd)
+**
+**	Description:
+**		Counts the bits of one transaction on the shared I2C bus and waits
+**		for the time they take, then hands the bytes to the emulator of the
+**		display
+**
+-----------------------------------------------------------------------*/
+void BusSend(void* pvCtx, const uint8_t* rgbSnd, uint8_t cbSnd)
+{
+    uint32_t cFrame = (cbSnd + I2C_FRAME_MAX - 1) / I2C_FRAME_MAX;
+    uint32_t cbit = 9 * (uint32_t)cbSnd + I2C_FRAME_BITS * cFrame;
+    delayMicroseconds(BusUs(cbitBus + cbit) - BusUs(cbitBus));
+    cbitBus += cbit;
+    cbBus += cbSnd;
+    if (pvCtx != &rgemu[0] && rglcds[0].IsBusy()) {
+        cbitOverlap += cbit;
+    }
+    LCDSEmu::Send(pvCtx, rgbSnd, cbSnd);
+}
+/* ------------------------------------------------------------------- */
+/** void  RunFrames(const char* szMode, boolean fGroup, boolean fLate)
+**
+**	Parameters:
+**		szMode - the name printed in the first column
+**		fGroup - true to send through LCDSGroup, false to drain each display in turn
+**		fLate - true to queue the counters once the slow display is busy
+**
+**	Description:
+**		Queues the frames on all the displays and sends them, measuring when
+**		the queue of each display becomes empty
+**
+-----------------------------------------------------------------------*/
+void RunFrames(const char* szMode, boolean fGroup, boolean fLate)
+{
+    LCDSGroup group;
+    uint32_t usCounter = 0;
+    uint32_t usSlow = 0;
+    cbitBus = 0;
+    cbBus = 0;
+    cbitOverlap = 0;
+    cMismatch = 0;
+    for (uint8_t idxDisp = 0; idxDisp < DISP_COUNT; idxDisp++) {
+        rgemu[idxDisp].Reset();
+        rglcds[idxDisp].Begin(BusSend, &rgemu[idxDisp]);
+        rglcds[idxDisp].DisplayClear();
+        if (fGroup) {
+            group.Add(&rglcds[idxDisp]);
+        }
+        else {
+            rglcds[idxDisp].AsyncEnable(true);
+        }
+    }
+    for (uint8_t idxFrame = 0; idxFrame < FRAME_COUNT; idxFrame++) {
+        uint32_t usStart = micros();
+        uint32_t usCounterStart = usStart;
+        boolean rgfDone[DISP_COUNT] = {false};
+        boolean fCounters = !fLate;
+        uint8_t cDone = 0;
+        QueueSlow(idxFrame);
+        if (fCounters) {
+            QueueCounters(idxFrame);
+        }
+        //time when each queue becomes empty, polled the way the mode does it
+        while (cDone < DISP_COUNT) {
+            if (!fCounters && rglcds[0].IsBusy()) {
+                usCounterStart = micros();
+                QueueCounters(idxFrame);
+                fCounters = true;
+            }
+            if (fGroup) {
+                group.Poll();
+            }
+            else {
+                rglcds[cDone].Poll();
+            }
+            for (uint8_t idxDisp = 0; idxDisp < DISP_COUNT; idxDisp++) {
+                if (!rgfDone[idxDisp] && (idxDisp == 0 || fCounters) && rglcds[idxDisp].GetQueueDepth() == 0) {
+                    rgfDone[idxDisp] = true;
+                    cDone++;
+                    if (idxDisp == 0) {
+                        usSlow += micros() - usStart;
+                    }
+                    else {
+                        usCounter += micros() - usCounterStart;
+                    }
+                }
+            }
+        }
+        //the next frame starts once the slow display is done
+        while (rglcds[0].IsBusy()) {
+        }
+        CheckFrame(idxFrame);
+    }
+    Serial.print(szMode);
+    Serial.print(',');
+    Serial.print(cbBus);
+    Serial.print(',');
+    Serial.print(BusUs(cbitBus));
+    Serial.print(',');
+    Serial.print(usCounter / ((DISP_COUNT - 1) * FRAME_COUNT));
+    Serial.print(',');
+    Serial.print(usSlow / FRAME_COUNT);
+    Serial.print(',');
+    Serial.print(BusUs(cbitOverlap));
+    Serial.print(',');
+    Serial.println(cMismatch);
+}
+/* ------------------------------------------------------------------- */
+/** void  QueueSlow(uint8_t idxFrame)
+**	void  QueueCounters(uint8_t idxFrame)
+**
+**	Description:
+**		Issue the commands of one frame on the slow display and on the counter
+**		displays, they are only queued since the displays are in asynchronous mode
+**
+-----------------------------------------------------------------------*/
+void QueueSlow(uint8_t idxFrame)
+{
+    rgbGlyph[7] = idxFrame;
+    rglcds[0].DefineUserChars(rgbGlyph, 0, 1);
+    rglcds[0].UpdateDisplay((idxFrame % 2) ? "Status: running " : "Status: idle    ",
+                            (idxFrame % 2) ? "Load 87% Fan hi " : "Load 12% Fan lo ");
+}
+
+void QueueCounters(uint8_t idxFrame)
+{
+    for (uint8_t idxDisp = 1; idxDisp < DISP_COUNT; idxDisp++) {
+        rglcds[idxDisp].WriteNumberAtPos(0, 0, (uint32_t)idxFrame * 37 + idxDisp, 8);
+    }
+}
+/* ------------------------------------------------------------------- */
+/** void  CheckFrame(uint8_t idxFrame)
+**
+**	Description:
+**		Counts a mismatch for each emulator that does not show the frame
+**
+-----------------------------------------------------------------------*/
+void CheckFrame(uint8_t idxFrame)
+{
+    char szRow[LCDSEMU_VISIBLE_COLS + 1];
+    rgemu[0].GetVisibleRow(1, szRow);
+    if (strncmp(szRow, (idxFrame % 2) ? "Load 87% Fan hi " : "Load 12% Fan lo ", LCDSEMU_VISIBLE_COLS) != 0 ||
+        rgemu[0].Glyph(0)[7] != (idxFrame & 0x1F)) {
+        cMismatch++;
+    }
+    for (uint8_t idxDisp = 1; idxDisp < DISP_COUNT; idxDisp++) {
+        uint32_t n = (uint32_t)idxFrame * 37 + idxDisp;
+        for (int8_t idxCol = 7; idxCol >= 0; idxCol--) {
+            char ch = (idxCol == 7 || n != 0) ? '0' + n % 10 : ' ';
+            if (rgemu[idxDisp].CharAt(0, idxCol) != ch) {
+                cMismatch++;
+                break;
+            }
+            n /= 10;
+        }
+    }
+}
+/* ------------------------------------------------------------------- */
+/** uint32_t  BusUs(uint32_t cbit)
+**
+**	Description:
+**		Returns the time taken by a number of bits on the I2C bus, in us
+**
+-----------------------------------------------------------------------*/
+uint32_t BusUs(uint32_t cbit)
+{
+    return (uint32_t)(((uint64_t)cbit * 1000000 + I2C_HZ / 2) / I2C_HZ);
+}